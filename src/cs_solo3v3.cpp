@@ -7,6 +7,13 @@
 #include "BattlegroundMgr.h"
 #include "CommandScript.h"
 #include "solo3v3_sc.h"
+#include "solo3v3_bench.h"
+#include "solo3v3_config.h"
+#include "solo3v3_simulator.h"
+#include "solo3v3_stats.h"
+#include "solo3v3_temp_teams.h"
+#include "solo3v3_trace.h"
+#include "solo3v3_wait_stats.h"
 
 using namespace Acore::ChatCommands;
 
@@ -21,6 +28,12 @@ public:
         {
             { "rated",       HandleQueueArena3v3Rated,         SEC_PLAYER,        Console::No },
             { "unrated",     HandleQueueArena3v3UnRated,       SEC_PLAYER,        Console::No },
+            { "pool",        HandleSoloTempTeamPool,           SEC_GAMEMASTER,    Console::Yes },
+            { "simulate",    HandleSoloSimulate,               SEC_ADMINISTRATOR, Console::Yes },
+            { "bench",       HandleSoloBench,                  SEC_ADMINISTRATOR, Console::Yes },
+            { "replay",      HandleSoloReplay,                 SEC_ADMINISTRATOR, Console::Yes },
+            { "stats",       HandleSoloStats,                  SEC_ADMINISTRATOR, Console::Yes },
+            { "waits",       HandleSoloWaits,                  SEC_ADMINISTRATOR, Console::Yes },
         };
 
         static ChatCommandTable SoloCommandTable =
@@ -48,13 +61,13 @@ public:
         if (!player)
             return false;
 
-        if (!sConfigMgr->GetOption<bool>("Solo.3v3.EnableCommand", true))
+        if (!sSolo3v3Config.EnableCommand)
         {
             ChatHandler(player->GetSession()).SendSysMessage("Solo 3v3 Arena command is disabled.");
             return false;
         }
 
-        if (!sConfigMgr->GetOption<bool>("Solo.3v3.Enable", true))
+        if (!sSolo3v3Config.Enable)
         {
             ChatHandler(player->GetSession()).SendSysMessage("Solo 3v3 Arena is disabled.");
             return false;
@@ -67,7 +80,7 @@ public:
         }
 
         NpcSolo3v3 SoloCommand;
-        if (player->HasAura(26013) && (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true) || sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true)))
+        if (player->HasAura(26013) && sSolo3v3Config.CastDeserter())
         {
             WorldPacket data;
             sBattlegroundMgr->BuildGroupJoinedBattlegroundPacket(&data, ERR_GROUP_JOIN_BATTLEGROUND_DESERTERS);
@@ -75,7 +88,7 @@ public:
             return false;
         }
 
-        uint32 minLevel = sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 80);
+        uint32 minLevel = sSolo3v3Config.MinLevel;
         if (player->GetLevel() < minLevel)
         {
             ChatHandler(player->GetSession()).PSendSysMessage("You need level {}+ to join solo arena.", minLevel);
@@ -102,6 +115,204 @@ public:
         return true;
     }
 
+    static bool HandleSoloTempTeamPool(ChatHandler* handler, const char* /*args*/)
+    {
+        Solo3v3TempTeamPoolStats stats = sSolo3v3TempTeams->GetStats();
+
+        handler->PSendSysMessage("Solo 3v3 temp arena teams: {} in use, {} created.", stats.inUse, stats.created);
+        return true;
+    }
+
+    // .qsolo simulate [players] [arrivals per tick] [healer %] [melee %] [mmr mean] [mmr deviation]
+    // Runs the match selection with the current settings on a synthetic queue. Blocks the world thread while running,
+    // for at most Solo3v3SimulationSettings::timeLimit ms.
+    static bool HandleSoloSimulate(ChatHandler* handler, const char* args)
+    {
+        Solo3v3SimulationSettings settings;
+
+        // missing parameters keep their default
+        std::istringstream params(args ? args : "");
+        for (uint32* param : { &settings.players, &settings.arrivalsPerTick, &settings.healerPercent, &settings.meleePercent, &settings.mmrMean, &settings.mmrDeviation })
+        {
+            uint32 value;
+            if (!(params >> value))
+                break;
+
+            *param = value;
+        }
+
+        if (!settings.players || !settings.arrivalsPerTick || settings.players > 20000 || settings.healerPercent + settings.meleePercent > 100)
+        {
+            handler->SendSysMessage("Usage: .qsolo simulate [players (max 20000)] [arrivals per tick] [healer %] [melee %] [mmr mean] [mmr deviation]");
+            return false;
+        }
+
+        // every 3v3 team needs a melee, a ranged and a healer, the queue would only grow until the time limit
+        if (!sBattlegroundMgr->isArenaTesting() && (!settings.healerPercent || !settings.meleePercent || settings.healerPercent + settings.meleePercent >= 100))
+        {
+            handler->SendSysMessage("The synthetic queue needs healers, melee and ranged players to form any match.");
+            return false;
+        }
+
+        Solo3v3SimulationResult result = Solo3v3Simulator::Run(settings);
+
+        double seconds = result.totalTime / 1000000.0;
+
+        if (result.timedOut)
+            handler->PSendSysMessage("Stopped after {} ms, {} of {} players arrived.", settings.timeLimit, result.arrived, settings.players);
+
+        handler->PSendSysMessage("Solo 3v3 simulation: {} players, {} matches, {} unmatched, {} ticks.", result.arrived, result.matches, result.unmatched, result.ticks);
+        handler->PSendSysMessage("Matcher: {:.0f} matches/sec, tick p50 {} us, p99 {} us, max {} us, {} snapshot reallocations.",
+            seconds > 0 ? result.matches / seconds : 0.0, result.tickP50, result.tickP99, result.tickMax, result.snapshotReallocations);
+        handler->SendSysMessage("Only the match selection is simulated, temp teams and the rating and rank updates are not.");
+        handler->PSendSysMessage("Queue wait: p50 {} s, p90 {} s, p99 {} s.", result.waitP50 / IN_MILLISECONDS, result.waitP90 / IN_MILLISECONDS, result.waitP99 / IN_MILLISECONDS);
+
+        return true;
+    }
+
+    // .qsolo bench [iterations]
+    // Micro benchmarks of the matcher hot paths, written to solo3v3_bench.json in the worldserver directory.
+    // The role and talent checks use the talents of the calling player. Blocks the world thread while running,
+    // the match selection over the large queues is capped to fewer iterations.
+    static bool HandleSoloBench(ChatHandler* handler, const char* args)
+    {
+        uint32 iterations = 1000;
+
+        std::istringstream params(args ? args : "");
+        uint32 value;
+        if (params >> value)
+            iterations = value;
+
+        if (!iterations || iterations > 100000)
+        {
+            handler->SendSysMessage("Usage: .qsolo bench [iterations (max 100000)]");
+            return false;
+        }
+
+        Player* player = handler->GetSession() ? handler->GetSession()->GetPlayer() : nullptr;
+        std::vector<Solo3v3BenchResult> results = Solo3v3Bench::Run(player, iterations);
+
+        for (Solo3v3BenchResult const& result : results)
+            handler->PSendSysMessage("{}: {:.0f} ns ({} iterations)", result.name, result.nsPerIteration, result.iterations);
+
+        if (!Solo3v3Bench::WriteJson(results, "solo3v3_bench.json"))
+        {
+            handler->SendSysMessage("Could not write solo3v3_bench.json.");
+            return false;
+        }
+
+        handler->SendSysMessage("Results written to solo3v3_bench.json.");
+        return true;
+    }
+
+    // .qsolo replay [file] [seed]
+    // Replays a recorded queue trace (Solo.3v3.Trace.File by default) through the match selection with the
+    // current settings. Blocks the world thread while running.
+    static bool HandleSoloReplay(ChatHandler* handler, const char* args)
+    {
+        std::string fileName = sSolo3v3Config.TraceFile;
+        uint32 seed = 1;
+
+        std::istringstream params(args ? args : "");
+        std::string fileParam;
+        if (params >> fileParam)
+            fileName = fileParam;
+
+        uint32 value;
+        if (params >> value)
+            seed = value;
+
+        // the recorder keeps the trace open, write what it still buffers first
+        sSolo3v3Trace->Flush();
+
+        std::vector<Solo3v3TraceRecord> records;
+        if (!Solo3v3TraceRecorder::Load(fileName, records))
+        {
+            handler->PSendSysMessage("Could not read the solo 3v3 trace {}.", fileName);
+            return false;
+        }
+
+        Solo3v3ReplayResult result = Solo3v3Simulator::Replay(records, seed);
+
+        handler->PSendSysMessage("Solo 3v3 replay of {}: {} events, {} joins, {} leaves, {} ticks, seed {}.", fileName, result.events, result.joins, result.leaves, result.ticks, seed);
+        handler->PSendSysMessage("Matches: {} recorded, {} replayed, {} players left unmatched.", result.recordedMatches, result.replayedMatches, result.unmatched);
+        handler->PSendSysMessage("Recorded queue wait: p50 {} s, p90 {} s, p99 {} s.", result.recordedWaitP50 / IN_MILLISECONDS, result.recordedWaitP90 / IN_MILLISECONDS, result.recordedWaitP99 / IN_MILLISECONDS);
+        handler->PSendSysMessage("Replayed queue wait: p50 {} s, p90 {} s, p99 {} s.", result.replayedWaitP50 / IN_MILLISECONDS, result.replayedWaitP90 / IN_MILLISECONDS, result.replayedWaitP99 / IN_MILLISECONDS);
+
+        return true;
+    }
+
+    // .qsolo stats [reset]
+    // Call rate and p50/p99/max duration of the module hooks since the server start or the last reset.
+    static bool HandleSoloStats(ChatHandler* handler, const char* args)
+    {
+        std::string param = args ? args : "";
+
+        if (param == "reset")
+        {
+            sSolo3v3HookStats->Reset();
+            handler->SendSysMessage("Solo 3v3 hook stats reset.");
+            return true;
+        }
+
+        if (!param.empty())
+        {
+            handler->SendSysMessage("Usage: .qsolo stats [reset]");
+            return false;
+        }
+
+        for (Solo3v3HookStats const& stats : sSolo3v3HookStats->GetStats())
+            handler->PSendSysMessage("{}: {} calls, {:.2f}/s, p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us",
+                stats.name, stats.calls, stats.callsPerSecond, stats.p50 / 1000.0, stats.p99 / 1000.0, stats.max / 1000.0);
+
+        return true;
+    }
+
+    // .qsolo waits [export]
+    // Recent queue wait per level bracket, rating and role. 'export' also writes them to solo3v3_waits.csv.
+    static bool HandleSoloWaits(ChatHandler* handler, const char* args)
+    {
+        std::string param = args ? args : "";
+
+        if (!param.empty() && param != "export")
+        {
+            handler->SendSysMessage("Usage: .qsolo waits [export]");
+            return false;
+        }
+
+        static char const* const roleNames[SOLO_3V3_WAIT_ROLES] = { "Melee", "Ranged", "Healer" };
+        bool found = false;
+
+        for (uint32 bracket = 0; bracket < MAX_BATTLEGROUND_BRACKETS; ++bracket)
+            for (bool isRated : { true, false })
+                for (uint8 role = 0; role < SOLO_3V3_WAIT_ROLES; ++role)
+                {
+                    Solo3v3WaitSummary summary = sSolo3v3WaitStats->GetSummary(BattlegroundBracketId(bracket), isRated, Solo3v3TalentCat(role));
+                    if (!summary.samples)
+                        continue;
+
+                    found = true;
+                    handler->PSendSysMessage("Bracket {} {} {}: {} invites ({:.1f} recent), mean {} s, p50 {} s, p90 {} s.", bracket, isRated ? "rated" : "unrated",
+                        roleNames[role], summary.samples, summary.weight, summary.mean / IN_MILLISECONDS, summary.p50 / IN_MILLISECONDS, summary.p90 / IN_MILLISECONDS);
+                }
+
+        if (!found)
+            handler->SendSysMessage("No solo 3v3 match formed yet.");
+
+        if (param == "export")
+        {
+            if (!sSolo3v3WaitStats->WriteCsv("solo3v3_waits.csv"))
+            {
+                handler->SendSysMessage("Could not write solo3v3_waits.csv.");
+                return false;
+            }
+
+            handler->SendSysMessage("Wait stats written to solo3v3_waits.csv.");
+        }
+
+        return true;
+    }
+
     // USED IN TESTING ONLY!!! (time saving when alt tabbing) Will join solo 3v3 on all players!
     // also use macros: /run AcceptBattlefieldPort(1,1); to accept queue and /afk to leave arena
     static bool HandleQueueSoloArenaTesting(ChatHandler* handler, const char* /*args*/)
@@ -110,13 +321,13 @@ public:
         if (!player)
             return false;
 
-        if (!sConfigMgr->GetOption<bool>("Solo.3v3.EnableTestingCommand", true))
+        if (!sSolo3v3Config.EnableTestingCommand)
         {
             ChatHandler(player->GetSession()).SendSysMessage("Solo 3v3 Arena testing command is disabled.");
             return false;
         }
 
-        if (!sConfigMgr->GetOption<bool>("Solo.3v3.Enable", true))
+        if (!sSolo3v3Config.Enable)
         {
             ChatHandler(player->GetSession()).SendSysMessage("Solo 3v3 Arena is disabled.");
             return false;
@@ -134,7 +345,7 @@ public:
                     continue;
                 }
 
-                if (currentPlayer->HasAura(26013) && (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true) || sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true)))
+                if (currentPlayer->HasAura(26013) && sSolo3v3Config.CastDeserter())
                 {
                     WorldPacket data;
                     sBattlegroundMgr->BuildGroupJoinedBattlegroundPacket(&data, ERR_GROUP_JOIN_BATTLEGROUND_DESERTERS);
@@ -142,7 +353,7 @@ public:
                     continue;
                 }
 
-                uint32 minLevel = sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 80);
+                uint32 minLevel = sSolo3v3Config.MinLevel;
                 if (currentPlayer->GetLevel() < minLevel)
                 {
                     handler->PSendSysMessage("Player {} needs level {}+ to join solo arena.", player->GetName().c_str(), minLevel);
@@ -16,6 +16,15 @@
  */
 
 #include "solo3v3.h"
+#include "solo3v3_config.h"
+#include "solo3v3_matchmaker.h"
+#include "solo3v3_queue_counters.h"
+#include "solo3v3_queue_index.h"
+#include "solo3v3_rank.h"
+#include "solo3v3_saver.h"
+#include "solo3v3_stats.h"
+#include "solo3v3_temp_teams.h"
+#include "solo3v3_trace.h"
 #include "ArenaTeamMgr.h"
 #include "BattlegroundMgr.h"
 #include "Config.h"
@@ -23,6 +32,8 @@
 #include "ScriptMgr.h"
 #include "Chat.h"
 #include "DisableMgr.h"
+#include "GameTime.h"
+#include <algorithm>
 
 uint32 ARENA_TYPE_3v3_SOLO = 4;
 uint32 ARENA_TEAM_SOLO_3v3 = 4;
@@ -36,19 +47,29 @@ Solo3v3* Solo3v3::instance()
     return &instance;
 }
 
-uint32 Solo3v3::GetAverageMMR(ArenaTeam* team)
+uint32 Solo3v3::GetAverageMMR(ArenaTeam* team, BattlegroundQueue::GroupsQueueType const& groups)
 {
     if (!team)
         return 0;
 
-    // this could be improved with a better balanced calculation
-    uint32 matchMakerRating = team->GetStats().Rating;
+    // average matchmaker rating of the queued groups, the same values the teams were balanced with
+    uint32 matchMakerRating = 0;
+    for (GroupQueueInfo const* ginfo : groups)
+        matchMakerRating += ginfo->ArenaMatchmakerRating;
+
+    if (!groups.empty())
+        matchMakerRating /= groups.size();
+
+    if (!matchMakerRating)
+        matchMakerRating = team->GetStats().Rating;
 
     return matchMakerRating;
 }
 
 void Solo3v3::CountAsLoss(Player* player, bool isInProgress)
 {
+    Solo3v3HookTimer timer(SOLO_3V3_HOOK_COUNT_AS_LOSS);
+
     if (player->IsSpectator())
         return;
 
@@ -62,12 +83,12 @@ void Solo3v3::CountAsLoss(Player* player, bool isInProgress)
     // leave while arena is in progress
     if (isInProgress)
     {
-        ratingLoss = sConfigMgr->GetOption<int32>("Solo.3v3.RatingPenalty.LeaveDuringMatch", 24);
+        ratingLoss = sSolo3v3Config.RatingPenaltyLeaveDuringMatch;
     }
     // leave while arena is in preparation || don't accept queue || logout while invited
     else
     {
-        ratingLoss = sConfigMgr->GetOption<int32>("Solo.3v3.RatingPenalty.LeaveBeforeMatchStart", 50);
+        ratingLoss = sSolo3v3Config.RatingPenaltyLeaveBeforeMatchStart;
     }
 
     ArenaTeamStats atStats = plrArenaTeam->GetStats();
@@ -79,14 +100,7 @@ void Solo3v3::CountAsLoss(Player* player, bool isInProgress)
 
     atStats.SeasonGames += 1;
     atStats.WeekGames += 1;
-    atStats.Rank = 1;
-
-    // Update team's rank, start with rank 1 and increase until no team with more rating was found
-    ArenaTeamMgr::ArenaTeamContainer::const_iterator i = sArenaTeamMgr->GetArenaTeamMapBegin();
-    for (; i != sArenaTeamMgr->GetArenaTeamMapEnd(); ++i) {
-        if (i->second->GetType() == ARENA_TEAM_SOLO_3v3 && i->second->GetStats().Rating > atStats.Rating)
-            ++atStats.Rank;
-    }
+    atStats.Rank = sSolo3v3Rank->UpdateRating(plrArenaTeam->GetId(), atStats.Rating);
 
     for (ArenaTeam::MemberList::iterator itr = plrArenaTeam->GetMembers().begin(); itr != plrArenaTeam->GetMembers().end(); ++itr) {
         if (itr->Guid == player->GetGUID()) {
@@ -105,7 +119,7 @@ void Solo3v3::CountAsLoss(Player* player, bool isInProgress)
 
     plrArenaTeam->SetArenaTeamStats(atStats);
     plrArenaTeam->NotifyStatsChanged();
-    plrArenaTeam->SaveToDB(true);
+    sSolo3v3Saver->SaveTeam(plrArenaTeam);
 }
 
 void Solo3v3::CleanUp3v3SoloQ(Battleground* bg)
@@ -117,16 +131,10 @@ void Solo3v3::CleanUp3v3SoloQ(Battleground* bg)
         ArenaTeam* tempHordeArenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(TEAM_HORDE));
 
         if (tempAlliArenaTeam && tempAlliArenaTeam->GetId() >= MAX_ARENA_TEAM_ID)
-        {
-            sArenaTeamMgr->RemoveArenaTeam(tempAlliArenaTeam->GetId());
-            delete tempAlliArenaTeam;
-        }
+            sSolo3v3TempTeams->Release(tempAlliArenaTeam);
 
         if (tempHordeArenaTeam && tempHordeArenaTeam->GetId() >= MAX_ARENA_TEAM_ID)
-        {
-            sArenaTeamMgr->RemoveArenaTeam(tempHordeArenaTeam->GetId());
-            delete tempHordeArenaTeam;
-        }
+            sSolo3v3TempTeams->Release(tempHordeArenaTeam);
     }
 }
 
@@ -156,133 +164,328 @@ void Solo3v3::CheckStartSolo3v3Arena(Battleground* bg)
     }
 
     // if one player didn't enter arena and StopGameIncomplete is true, then end arena
-    if (someoneNotInArena && sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true))
+    if (someoneNotInArena && sSolo3v3Config.StopGameIncomplete)
     {
         bg->SetRated(false);
         bg->EndBattleground(TEAM_NEUTRAL);
     }
 }
 
-bool Solo3v3::CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated)
+bool Solo3v3::CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated, bool& deferred)
 {
+    deferred = false;
+
+    Solo3v3HookTimer timer(SOLO_3V3_HOOK_CHECK_ARENA);
+
     queue->m_SelectionPools[TEAM_ALLIANCE].Init();
     queue->m_SelectionPools[TEAM_HORDE].Init();
 
-    uint32 MinPlayersPerTeam = sBattlegroundMgr->isArenaTesting() ? 1 : 3;
-    bool MeleeCasterHealer = sConfigMgr->GetOption<bool>("Solo.3v3.MeleeCasterHealer", false);
+    // work on a snapshot, the queue lists are only touched once a match is found
+    std::vector<Solo3v3Candidate> candidates;
+    Solo3v3MatchSelection selected;
+    Solo3v3MatchSettings settings = GetMatchSettings();
 
-    uint8 factionGroupTypeAlliance = isRated ? BG_QUEUE_PREMADE_ALLIANCE : BG_QUEUE_NORMAL_ALLIANCE;
-    uint8 factionGroupTypeHorde = isRated ? BG_QUEUE_PREMADE_HORDE : BG_QUEUE_NORMAL_HORDE;
+    // the MMR order comes from the queue index, only needed for the MMR window selection
+    Solo3v3MMROrder mmrOrder;
+    Solo3v3MMROrder* order = settings.UsesMMRWindow(isRated) ? &mmrOrder : nullptr;
 
-    struct TeamComposition
+    while (true)
     {
-        int healerCount = 0, meleeCount = 0, rangedCount = 0;
-        int getTotalPlayers() const { return healerCount + meleeCount + rangedCount; }
-        int getTotalDPS() const { return meleeCount + rangedCount; }
+        // a retry rebuilds the snapshot, the previous selection points into the old one
+        candidates.clear();
+        selected[TEAM_ALLIANCE].clear();
+        selected[TEAM_HORDE].clear();
+        BuildSolo3v3Candidates(queue, bracket_id, isRated, candidates, order);
+
+        if (!SelectSolo3v3Match(candidates, isRated, settings, selected, nullptr, order))
+            return false;
+
+        // the snapshot comes from the queue index, make sure the chosen groups are still in the queue.
+        // Entries that aren't are dropped from the index, so this ends once the index is clean.
+        bool valid = true;
+        for (uint8 teamId = TEAM_ALLIANCE; teamId < BG_TEAMS_COUNT; ++teamId)
+            for (Solo3v3Candidate const* candidate : selected[teamId])
+                if (!RevalidateSolo3v3Candidate(queue, bracket_id, candidates[candidate - candidates.data()]))
+                {
+                    sSolo3v3QueueCounters->RemovePlayer(candidate->playerGuid);
+                    if (sSolo3v3QueueIndex->RemovePlayer(candidate->playerGuid))
+                        sSolo3v3Trace->RecordPlayer(SOLO_3V3_TRACE_LEAVE, candidate->playerGuid);
+                    valid = false;
+                }
 
-        bool canAddPlayer(Solo3v3TalentCat role, bool MeleeCasterHealer) const
+        if (valid)
+            break;
+
+        // every retry rebuilds the snapshot, stop on the budget and go on from the pruned index next tick
+        if (sSolo3v3Matchmaker->BudgetExceeded())
         {
-            if (getTotalPlayers() >= 3) return false;
+            deferred = true;
+            return false;
+        }
+    }
 
-            if (MeleeCasterHealer)
-                if (role == HEALER && healerCount >= 1) return false;
-                if (role == MELEE && meleeCount >= 1) return false;
-                if (role == RANGE && rangedCount >= 1) return false;
-            else 
-                if (role == HEALER && healerCount >= 1) return false;
-                if (role != HEALER && getTotalDPS() >= 2) return false;
+    CommitSolo3v3Match(queue, bracket_id, isRated, selected);
+    return true;
+}
 
-            return true;
-        }
+Solo3v3MatchSettings Solo3v3::GetMatchSettings()
+{
+    Solo3v3Config const& config = sSolo3v3Config;
 
-        void addPlayer(Solo3v3TalentCat role)
-        {
-            if (role == HEALER) healerCount++;
-            else if (role == MELEE) meleeCount++;
-            else if (role == RANGE) rangedCount++;
-        }
+    Solo3v3MatchSettings settings;
+    settings.MinPlayersPerTeam = sBattlegroundMgr->isArenaTesting() ? 1 : 3;
+    settings.MMRWindow = config.MMRWindow;
+    settings.MMRWindowGrowth = config.MMRWindowGrowth;
+    settings.MMRWindowGrowthInterval = config.MMRWindowGrowthInterval;
+    settings.MMRWindowMax = config.MMRWindowMax;
 
-        bool isValidComposition(bool MeleeCasterHealer) const
+    return settings;
+}
+
+bool Solo3v3::SelectSolo3v3Match(std::vector<Solo3v3Candidate> const& candidates, bool isRated, Solo3v3MatchSettings const& settings, Solo3v3MatchSelection& selected,
+    std::mt19937* rng, Solo3v3MMROrder const* mmrOrder)
+{
+    if (!settings.UsesMMRWindow(isRated))
+        return SelectSolo3v3MatchInQueueOrder(candidates, settings.MinPlayersPerTeam, selected, rng);
+
+    if (mmrOrder)
+        return SelectSolo3v3MatchByMMR(candidates, settings, *mmrOrder, selected);
+
+    Solo3v3MMROrder sortedOrder;
+    BuildSolo3v3MMROrder(candidates, sortedOrder);
+    return SelectSolo3v3MatchByMMR(candidates, settings, sortedOrder, selected);
+}
+
+void Solo3v3::BuildSolo3v3MMROrder(std::vector<Solo3v3Candidate> const& candidates, Solo3v3MMROrder& mmrOrder)
+{
+    for (std::vector<uint32>& positions : mmrOrder)
+        positions.clear();
+
+    for (uint32 position = 0; position < candidates.size(); ++position)
+        if (candidates[position].role <= HEALER)
+            mmrOrder[candidates[position].role].push_back(position);
+
+    for (std::vector<uint32>& positions : mmrOrder)
+        std::sort(positions.begin(), positions.end(), [&candidates](uint32 left, uint32 right) { return candidates[left].mmr < candidates[right].mmr; });
+}
+
+void Solo3v3::CommitSolo3v3Match(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated, Solo3v3MatchSelection const& selected)
+{
+    uint32 MinPlayersPerTeam = sBattlegroundMgr->isArenaTesting() ? 1 : 3;
+
+    // move the chosen groups to their new faction list and fill the selection pools
+    for (uint8 teamId = TEAM_ALLIANCE; teamId < BG_TEAMS_COUNT; ++teamId)
+    {
+        uint8 targetIndex = (isRated ? BG_QUEUE_PREMADE_ALLIANCE : BG_QUEUE_NORMAL_ALLIANCE) + teamId;
+
+        for (Solo3v3Candidate const* candidate : selected[teamId])
         {
-            if (MeleeCasterHealer)
-                return healerCount == 1 && meleeCount == 1 && rangedCount == 1;
-            else
-                return healerCount == 1 && getTotalDPS() == 2;
+            GroupQueueInfo* ginfo = candidate->group;
+
+            if (candidate->queueIndex != targetIndex) // move to other team
+            {
+                ginfo->teamId = TeamId(teamId);
+                ginfo->GroupType = targetIndex;
+                queue->m_QueuedGroups[bracket_id][targetIndex].push_front(ginfo);
+                queue->m_QueuedGroups[bracket_id][candidate->queueIndex].erase(candidate->itr);
+                sSolo3v3QueueIndex->SetQueuePosition(candidate->playerGuid, targetIndex, queue->m_QueuedGroups[bracket_id][targetIndex].begin());
+            }
+
+            queue->m_SelectionPools[teamId].AddGroup(ginfo, MinPlayersPerTeam);
         }
-    };
+    }
+}
+
+bool Solo3v3::RevalidateSolo3v3Candidate(BattlegroundQueue* queue, BattlegroundBracketId /*bracket_id*/, Solo3v3Candidate& candidate)
+{
+    // only compare the group pointer until the player is known to be queued with it, it may have been freed since the snapshot
+    BattlegroundQueue::QueuedPlayersMap::const_iterator queued = queue->m_QueuedPlayers.find(candidate.playerGuid);
+    if (queued == queue->m_QueuedPlayers.end() || queued->second.GroupInfo != candidate.group)
+        return false;
+
+    if (candidate.group->IsInvitedToBGInstanceGUID)
+        return false;
 
-    TeamComposition teams[2]; // 0 = Alliance, 1 = Horde
+    // the group is still queued, so the position the index keeps for it is valid
+    return sSolo3v3QueueIndex->GetQueuePosition(candidate.playerGuid, candidate.group, candidate.queueIndex, candidate.itr);
+}
+
+bool Solo3v3::SelectSolo3v3MatchInQueueOrder(std::vector<Solo3v3Candidate> const& candidates, uint32 MinPlayersPerTeam, Solo3v3MatchSelection& selected, std::mt19937* rng)
+{
+    Solo3v3TeamComposition teams[BG_TEAMS_COUNT];
 
-    for (int teamId = 0; teamId < 2; teamId++) // BG_QUEUE_PREMADE_ALLIANCE and BG_QUEUE_PREMADE_HORDE
+    for (Solo3v3Candidate const& candidate : candidates)
     {
-        int index = teamId;
+        bool allianceCanAdd = teams[TEAM_ALLIANCE].getTotalPlayers() < MinPlayersPerTeam && teams[TEAM_ALLIANCE].canAddPlayer(candidate.role);
+        bool hordeCanAdd = teams[TEAM_HORDE].getTotalPlayers() < MinPlayersPerTeam && teams[TEAM_HORDE].canAddPlayer(candidate.role);
 
-        if (!isRated)
-            index += PVP_TEAMS_COUNT;
+        if (!allianceCanAdd && !hordeCanAdd)
+            continue;
 
-        for (BattlegroundQueue::GroupsQueueType::iterator itr = queue->m_QueuedGroups[bracket_id][index].begin(); itr != queue->m_QueuedGroups[bracket_id][index].end(); ++itr)
-        {
-            if ((*itr)->IsInvitedToBGInstanceGUID) // Skip when invited
-                continue;
+        TeamId targetTeam;
+        if (allianceCanAdd && hordeCanAdd)
+            targetTeam = (rng ? (*rng)() % 2 : urand(0, 1)) == 0 ? TEAM_ALLIANCE : TEAM_HORDE; // add players to random team
+        else
+            targetTeam = allianceCanAdd ? TEAM_ALLIANCE : TEAM_HORDE;
 
-            for (auto const& playerGuid : (*itr)->Players)
-            {
-                Player* plr = ObjectAccessor::FindPlayer(playerGuid);
-                if (!plr)
-                    continue;
+        teams[targetTeam].addPlayer(candidate.role);
+        selected[targetTeam].push_back(&candidate);
 
-                Solo3v3TalentCat playerRole = GetTalentCatForSolo3v3(plr);
+        if (teams[TEAM_ALLIANCE].getTotalPlayers() >= MinPlayersPerTeam && teams[TEAM_HORDE].getTotalPlayers() >= MinPlayersPerTeam)
+            break;
+    }
 
-                int targetTeam = -1;
+    // arena testing (.debug arena) forms 1v1 matches, the compositions and the rebalance only apply to 3v3
+    if (MinPlayersPerTeam != 3)
+        return selected[TEAM_ALLIANCE].size() == MinPlayersPerTeam && selected[TEAM_HORDE].size() == MinPlayersPerTeam;
 
-                bool allianceCanAdd = teams[TEAM_ALLIANCE].getTotalPlayers() < MinPlayersPerTeam && teams[TEAM_ALLIANCE].canAddPlayer(playerRole, MeleeCasterHealer);
-                bool hordeCanAdd = teams[TEAM_HORDE].getTotalPlayers() < MinPlayersPerTeam && teams[TEAM_HORDE].canAddPlayer(playerRole, MeleeCasterHealer);
+    if (!teams[TEAM_ALLIANCE].isValidComposition() || !teams[TEAM_HORDE].isValidComposition())
+        return false;
 
-                if (allianceCanAdd && hordeCanAdd)
-                    targetTeam = urand(0, 1) == 0 ? TEAM_ALLIANCE : TEAM_HORDE; // add players to random team
-                else
-                    targetTeam = allianceCanAdd ? TEAM_ALLIANCE : TEAM_HORDE; // se um team tiver cheio, adiciona no outro (se possivel)
+    // rebalance the sides of the chosen players
+    std::vector<Solo3v3Candidate const*> chosen(selected[TEAM_ALLIANCE].begin(), selected[TEAM_ALLIANCE].end());
+    chosen.insert(chosen.end(), selected[TEAM_HORDE].begin(), selected[TEAM_HORDE].end());
 
-                if (targetTeam == -1)
+    return SplitSolo3v3Teams(chosen, selected);
+}
+
+bool Solo3v3::SelectSolo3v3MatchByMMR(std::vector<Solo3v3Candidate> const& candidates, Solo3v3MatchSettings const& settings, Solo3v3MMROrder const& mmrOrder, Solo3v3MatchSelection& selected)
+{
+    uint32 baseWindow = settings.MMRWindow;
+    uint32 windowGrowth = settings.MMRWindowGrowth;
+    uint32 growthInterval = settings.MMRWindowGrowthInterval;
+    uint32 maxWindow = settings.MMRWindowMax;
+
+    if (mmrOrder[HEALER].size() < BG_TEAMS_COUNT || mmrOrder[MELEE].size() < BG_TEAMS_COUNT || mmrOrder[RANGE].size() < BG_TEAMS_COUNT)
+        return false;
+
+    auto lowerMMR = [&candidates](uint32 position, uint32 mmr) { return candidates[position].mmr < mmr; };
+    auto upperMMR = [&candidates](uint32 mmr, uint32 position) { return mmr < candidates[position].mmr; };
+
+    // the candidates are in join order, so the longest waiting player is the first anchor. Its window widens with its wait time.
+    for (uint32 anchorPosition = 0; anchorPosition < candidates.size(); ++anchorPosition)
+    {
+        Solo3v3Candidate const& anchor = candidates[anchorPosition];
+
+        uint32 window = baseWindow + (growthInterval ? anchor.waitTime / growthInterval * windowGrowth : 0);
+        if (maxWindow && window > maxWindow)
+            window = maxWindow;
+
+        uint32 minMMR = anchor.mmr > window ? anchor.mmr - window : 0;
+        uint32 maxMMR = anchor.mmr + window;
+
+        std::pair<std::vector<uint32>::const_iterator, std::vector<uint32>::const_iterator> band[HEALER + 1];
+        for (uint8 role = MELEE; role <= HEALER; ++role)
+        {
+            band[role].first = std::lower_bound(mmrOrder[role].begin(), mmrOrder[role].end(), minMMR, lowerMMR);
+            band[role].second = std::upper_bound(band[role].first, mmrOrder[role].end(), maxMMR, upperMMR);
+        }
+
+        // every team needs a melee, a ranged and a healer (Solo3v3TeamComposition), so two of each inside the window
+        std::size_t melee = band[MELEE].second - band[MELEE].first;
+        std::size_t range = band[RANGE].second - band[RANGE].first;
+        std::size_t healer = band[HEALER].second - band[HEALER].first;
+
+        if (healer < BG_TEAMS_COUNT || melee < BG_TEAMS_COUNT || range < BG_TEAMS_COUNT)
+            continue;
+
+        // the anchor, then the two longest waiting players of each role inside the window (lowest snapshot positions)
+        std::vector<Solo3v3Candidate const*> chosen;
+        chosen.reserve(SOLO_3V3_MATCH_PLAYERS);
+
+        for (uint8 role = MELEE; role <= HEALER; ++role)
+        {
+            uint32 oldest[BG_TEAMS_COUNT] = { UINT32_MAX, UINT32_MAX };
+
+            for (std::vector<uint32>::const_iterator itr = band[role].first; itr != band[role].second; ++itr)
+            {
+                if (*itr == anchorPosition)
                     continue;
 
-                if (targetTeam == TEAM_ALLIANCE)
-                {
-                    if (queue->m_SelectionPools[TEAM_ALLIANCE].AddGroup((*itr), MinPlayersPerTeam)) // added successfully?
-                    {
-                        teams[TEAM_ALLIANCE].addPlayer(playerRole);
-
-                        if ((*itr)->teamId != TEAM_ALLIANCE) // move to other team
-                        {
-                            (*itr)->teamId = TEAM_ALLIANCE;
-                            (*itr)->GroupType = factionGroupTypeAlliance;
-                            queue->m_QueuedGroups[bracket_id][factionGroupTypeAlliance].push_front((*itr));
-                            itr = queue->m_QueuedGroups[bracket_id][factionGroupTypeHorde].erase(itr);
-                            return CheckSolo3v3Arena(queue, bracket_id, isRated);
-                        }
-                    }
-                }
-                else // targetTeam == TEAM_HORDE
+                if (*itr < oldest[0])
                 {
-                    if (queue->m_SelectionPools[TEAM_HORDE].AddGroup((*itr), MinPlayersPerTeam))
-                    {
-                        teams[TEAM_HORDE].addPlayer(playerRole);
-
-                        if ((*itr)->teamId != TEAM_HORDE) // move to other team
-                        {
-                            (*itr)->teamId = TEAM_HORDE;
-                            (*itr)->GroupType = factionGroupTypeHorde;
-                            queue->m_QueuedGroups[bracket_id][factionGroupTypeHorde].push_front((*itr));
-                            itr = queue->m_QueuedGroups[bracket_id][factionGroupTypeAlliance].erase(itr);
-                            return CheckSolo3v3Arena(queue, bracket_id, isRated);
-                        }
-                    }
+                    oldest[1] = oldest[0];
+                    oldest[0] = *itr;
                 }
+                else if (*itr < oldest[1])
+                    oldest[1] = *itr;
+            }
+
+            if (role == anchor.role)
+            {
+                oldest[1] = oldest[0];
+                oldest[0] = anchorPosition;
             }
+
+            for (uint32 position : oldest)
+                chosen.push_back(&candidates[position]);
         }
+
+        if (SplitSolo3v3Teams(chosen, selected))
+            return true;
     }
 
-    return teams[TEAM_ALLIANCE].isValidComposition(MeleeCasterHealer) && teams[TEAM_HORDE].isValidComposition(MeleeCasterHealer);
+    return false;
+}
+
+bool Solo3v3::SplitSolo3v3Teams(std::vector<Solo3v3Candidate const*> const& chosen, Solo3v3MatchSelection& selected)
+{
+    if (chosen.size() != SOLO_3V3_MATCH_PLAYERS)
+        return false;
+
+    uint32 totalMMR = 0;
+    for (Solo3v3Candidate const* candidate : chosen)
+        totalMMR += candidate->mmr;
+
+    int32 bestSplit = -1;
+    uint32 bestMMRGap = 0;
+
+    for (uint8 split = 0; split < SOLO_3V3_TEAM_SPLIT_COUNT; ++split)
+    {
+        Solo3v3TeamComposition teams[BG_TEAMS_COUNT];
+        uint32 allianceMMR = 0;
+        bool valid = true;
+
+        for (uint8 i = 0; i < SOLO_3V3_MATCH_PLAYERS && valid; ++i)
+        {
+            uint8 teamId = (SOLO_3V3_TEAM_SPLITS[split] & (1 << i)) ? TEAM_ALLIANCE : TEAM_HORDE;
+
+            valid = teams[teamId].canAddPlayer(chosen[i]->role);
+            teams[teamId].addPlayer(chosen[i]->role);
+
+            if (teamId == TEAM_ALLIANCE)
+                allianceMMR += chosen[i]->mmr;
+        }
+
+        if (!valid || !teams[TEAM_ALLIANCE].isValidComposition() || !teams[TEAM_HORDE].isValidComposition())
+            continue;
+
+        // both teams have 3 players, so the gap of the MMR sums is 3 times the gap of the averages
+        uint32 hordeMMR = totalMMR - allianceMMR;
+        uint32 mmrGap = allianceMMR > hordeMMR ? allianceMMR - hordeMMR : hordeMMR - allianceMMR;
+
+        if (bestSplit < 0 || mmrGap < bestMMRGap)
+        {
+            bestSplit = split;
+            bestMMRGap = mmrGap;
+        }
+    }
+
+    if (bestSplit < 0)
+        return false;
+
+    selected[TEAM_ALLIANCE].clear();
+    selected[TEAM_HORDE].clear();
+
+    for (uint8 i = 0; i < SOLO_3V3_MATCH_PLAYERS; ++i)
+        selected[(SOLO_3V3_TEAM_SPLITS[bestSplit] & (1 << i)) ? TEAM_ALLIANCE : TEAM_HORDE].push_back(chosen[i]);
+
+    return true;
+}
+
+void Solo3v3::BuildSolo3v3Candidates(BattlegroundQueue* /*queue*/, BattlegroundBracketId bracket_id, bool isRated, std::vector<Solo3v3Candidate>& candidates, Solo3v3MMROrder* mmrOrder)
+{
+    sSolo3v3QueueIndex->BuildCandidates(bracket_id, isRated, GameTime::GetGameTimeMS().count(), candidates, mmrOrder);
 }
 
 void Solo3v3::CreateTempArenaTeamForQueue(BattlegroundQueue* queue, ArenaTeam* arenaTeams[])
@@ -290,7 +493,6 @@ void Solo3v3::CreateTempArenaTeamForQueue(BattlegroundQueue* queue, ArenaTeam* a
     // Create temp arena team
     for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
     {
-        ArenaTeam* tempArenaTeam = new ArenaTeam();  // delete it when all players have left the arena match. Stored in sArenaTeamMgr
         std::vector<Player*> playersList;
         uint32 atPlrItr = 0;
 
@@ -302,7 +504,12 @@ void Solo3v3::CreateTempArenaTeamForQueue(BattlegroundQueue* queue, ArenaTeam* a
             for (auto const& itr2 : itr->Players)
             {
                 auto _PlayerGuid = itr2;
-                if (Player * _player = ObjectAccessor::FindPlayer(_PlayerGuid))
+                // invited right after, so the player is still in the queue index
+                Player* _player = sSolo3v3QueueIndex->GetPlayer(_PlayerGuid);
+                if (!_player)
+                    _player = ObjectAccessor::FindPlayer(_PlayerGuid);
+
+                if (_player)
                 {
                     playersList.push_back(_player);
                     atPlrItr++;
@@ -315,9 +522,8 @@ void Solo3v3::CreateTempArenaTeamForQueue(BattlegroundQueue* queue, ArenaTeam* a
         std::stringstream ssTeamName;
         ssTeamName << "3v3 Solo Team - " << (i + 1);
 
-        tempArenaTeam->CreateTempArenaTeam(playersList, ARENA_TEAM_SOLO_3v3, ssTeamName.str());
-        sArenaTeamMgr->AddArenaTeam(tempArenaTeam);
-        arenaTeams[i] = tempArenaTeam;
+        // given back to the pool when the arena is destroyed. Stored in sArenaTeamMgr
+        arenaTeams[i] = sSolo3v3TempTeams->Acquire(playersList, ssTeamName.str());
     }
 }
 
@@ -326,30 +532,10 @@ bool Solo3v3::Arena3v3CheckTalents(Player* player)
     if (!player)
         return false;
 
-    if (!sConfigMgr->GetOption<bool>("Arena.3v3.BlockForbiddenTalents", false))
+    if (!sSolo3v3Config.BlockForbiddenTalents)
         return true;
 
-    uint32 count = 0;
-    for (uint32 talentId = 0; talentId < sTalentStore.GetNumRows(); ++talentId)
-    {
-        TalentEntry const* talentInfo = sTalentStore.LookupEntry(talentId);
-
-        if (!talentInfo)
-            continue;
-
-        for (int8 rank = MAX_TALENT_RANK - 1; rank >= 0; --rank)
-        {
-            if (talentInfo->RankID[rank] == 0)
-                continue;
-
-            if (player->HasTalent(talentInfo->RankID[rank], player->GetActiveSpec()))
-            {
-                for (int8 i = 0; FORBIDDEN_TALENTS_IN_1V1_ARENA[i] != 0; i++)
-                    if (FORBIDDEN_TALENTS_IN_1V1_ARENA[i] == talentInfo->TalentTab)
-                        count += rank + 1;
-            }
-        }
-    }
+    uint32 count = CountTalentPoints(player).forbidden;
 
     if (count >= 36)
     {
@@ -362,52 +548,88 @@ bool Solo3v3::Arena3v3CheckTalents(Player* player)
 
 Solo3v3TalentCat Solo3v3::GetTalentCatForSolo3v3(Player* player)
 {
-    uint32 count[MAX_TALENT_CAT];
+    Solo3v3TalentPoints talentPoints = CountTalentPoints(player);
+
+    uint32 prevCount = 0;
+
+    Solo3v3TalentCat talCat = MELEE; // Default MELEE (if no talent points set)
 
     for (int i = 0; i < MAX_TALENT_CAT; i++)
-        count[i] = 0;
+    {
+        if (talentPoints.talentCat[i] > prevCount)
+        {
+            talCat = (Solo3v3TalentCat)i;
+            prevCount = talentPoints.talentCat[i];
+        }
+    }
+
+    return talCat;
+}
 
-    for (uint32 talentId = 0; talentId < sTalentStore.GetNumRows(); ++talentId)
+Solo3v3TalentPoints Solo3v3::CountTalentPoints(Player* player)
+{
+    Solo3v3TalentPoints talentPoints;
+    uint8 spec = player->GetActiveSpec();
+
+    for (auto const& [spellId, talent] : player->GetTalentMap())
     {
-        TalentEntry const* talentInfo = sTalentStore.LookupEntry(talentId);
+        if (talent->State == PLAYERSPELL_REMOVED || !talent->IsInSpec(spec))
+            continue;
 
-        if (!talentInfo)
+        TalentSpellPos const* talentPos = GetTalentSpellPos(spellId);
+        if (!talentPos)
             continue;
 
-        for (int8 rank = MAX_TALENT_RANK - 1; rank >= 0; --rank)
-        {
-            if (talentInfo->RankID[rank] == 0)
-                continue;
+        TalentEntry const* talentInfo = sTalentStore.LookupEntry(talentPos->talent_id);
+        if (!talentInfo || talentInfo->TalentTab >= SOLO_3V3_TALENT_TAB_COUNT)
+            continue;
 
-            if (player->HasTalent(talentInfo->RankID[rank], player->GetActiveSpec()))
-            {
-                for (int8 i = 0; SOLO_3V3_TALENTS_MELEE[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_MELEE[i] == talentInfo->TalentTab)
-                        count[MELEE] += rank + 1;
+        Solo3v3TalentTabInfo const& tabInfo = SOLO_3V3_TALENT_TABS[talentInfo->TalentTab];
+        uint32 points = talentPos->rank + 1;
 
-                for (int8 i = 0; SOLO_3V3_TALENTS_RANGE[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_RANGE[i] == talentInfo->TalentTab)
-                        count[RANGE] += rank + 1;
+        if (tabInfo.talentCat != MAX_TALENT_CAT)
+            talentPoints.talentCat[tabInfo.talentCat] += points;
 
-                for (int8 i = 0; SOLO_3V3_TALENTS_HEAL[i] != 0; i++)
-                    if (SOLO_3V3_TALENTS_HEAL[i] == talentInfo->TalentTab)
-                        count[HEALER] += rank + 1;
-            }
-        }
+        if (tabInfo.forbidden)
+            talentPoints.forbidden += points;
     }
 
-    uint32 prevCount = 0;
+    return talentPoints;
+}
 
-    Solo3v3TalentCat talCat = MELEE; // Default MELEE (if no talent points set)
+Solo3v3TalentCat Solo3v3::GetCachedTalentCat(Player* player)
+{
+    uint8 spec = player->GetActiveSpec();
 
-    for (int i = 0; i < MAX_TALENT_CAT; i++)
     {
-        if (count[i] > prevCount)
-        {
-            talCat = (Solo3v3TalentCat)i;
-            prevCount = count[i];
-        }
+        std::lock_guard<std::mutex> guard(talentCatCacheLock);
+
+        Solo3v3TalentCat talCat = talentCatCache[player->GetGUID()].talentCat[spec];
+        if (talCat != MAX_TALENT_CAT)
+            return talCat;
     }
 
+    Solo3v3TalentCat talCat = GetTalentCatForSolo3v3(player);
+
+    std::lock_guard<std::mutex> guard(talentCatCacheLock);
+    talentCatCache[player->GetGUID()].talentCat[spec] = talCat;
+
     return talCat;
 }
+
+void Solo3v3::InvalidateTalentCat(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> guard(talentCatCacheLock);
+    talentCatCache.erase(guid);
+}
+
+void Solo3v3::RefreshQueuedRole(Player* player)
+{
+    // skip the talent scan for players who aren't waiting in the solo queue
+    if (sSolo3v3QueueIndex->GetRole(player->GetGUID()) == MAX_TALENT_CAT)
+        return;
+
+    Solo3v3TalentCat role = GetCachedTalentCat(player);
+    sSolo3v3QueueIndex->UpdateRole(player->GetGUID(), role);
+    sSolo3v3QueueCounters->UpdateRole(player->GetGUID(), role);
+}
@@ -22,6 +22,11 @@
 #include "ArenaTeamMgr.h"
 #include "BattlegroundMgr.h"
 #include "Player.h"
+#include <array>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
 
 // Custom 1v1 Arena Rated
 constexpr uint32 BATTLEGROUND_QUEUE_1v1 = 11;
@@ -33,7 +38,7 @@ extern uint32 ARENA_SLOT_SOLO_3v3;
 extern uint32 BATTLEGROUND_QUEUE_3v3_SOLO;
 extern BattlegroundQueueTypeId bgQueueTypeId;
 
-const uint32 FORBIDDEN_TALENTS_IN_1V1_ARENA[] =
+constexpr uint32 FORBIDDEN_TALENTS_IN_1V1_ARENA[] =
 {
     // Healer
     201, // PriestDiscipline
@@ -46,7 +51,7 @@ const uint32 FORBIDDEN_TALENTS_IN_1V1_ARENA[] =
 
 // SOLO_3V3_TALENTS found in: TalentTab.dbc -> TalentTabID
 // Warrior, Rogue, Deathknight etc.
-const uint32 SOLO_3V3_TALENTS_MELEE[] =
+constexpr uint32 SOLO_3V3_TALENTS_MELEE[] =
 {
     383, // PaladinProtection
     163, // WarriorProtection
@@ -65,7 +70,7 @@ const uint32 SOLO_3V3_TALENTS_MELEE[] =
 };
 
 // Mage, Hunter, Warlock etc.
-const uint32 SOLO_3V3_TALENTS_RANGE[] =
+constexpr uint32 SOLO_3V3_TALENTS_RANGE[] =
 {
     81,  // Arcane mage
     261, // Elemental Shaman
@@ -82,7 +87,7 @@ const uint32 SOLO_3V3_TALENTS_RANGE[] =
     0 // End
 };
 
-const uint32 SOLO_3V3_TALENTS_HEAL[] =
+constexpr uint32 SOLO_3V3_TALENTS_HEAL[] =
 {
     201, // PriestDiscipline
     202, // PriestHoly
@@ -110,25 +115,211 @@ enum Solo3v3TalentCat
     MAX_TALENT_CAT
 };
 
+// TalentTab.dbc ids are below 412 in 3.3.5a
+constexpr uint32 SOLO_3V3_TALENT_TAB_COUNT = 412;
+
+struct Solo3v3TalentTabInfo
+{
+    uint8 talentCat = MAX_TALENT_CAT; // MELEE, RANGE, HEALER or MAX_TALENT_CAT if the tab has no role
+    bool forbidden = false;           // listed in FORBIDDEN_TALENTS_IN_1V1_ARENA
+};
+
+constexpr std::array<Solo3v3TalentTabInfo, SOLO_3V3_TALENT_TAB_COUNT> BuildSolo3v3TalentTabs()
+{
+    std::array<Solo3v3TalentTabInfo, SOLO_3V3_TALENT_TAB_COUNT> talentTabs{};
+
+    for (uint32 i = 0; SOLO_3V3_TALENTS_MELEE[i] != 0; ++i)
+        talentTabs[SOLO_3V3_TALENTS_MELEE[i]].talentCat = MELEE;
+
+    for (uint32 i = 0; SOLO_3V3_TALENTS_RANGE[i] != 0; ++i)
+        talentTabs[SOLO_3V3_TALENTS_RANGE[i]].talentCat = RANGE;
+
+    for (uint32 i = 0; SOLO_3V3_TALENTS_HEAL[i] != 0; ++i)
+        talentTabs[SOLO_3V3_TALENTS_HEAL[i]].talentCat = HEALER;
+
+    for (uint32 i = 0; FORBIDDEN_TALENTS_IN_1V1_ARENA[i] != 0; ++i)
+        talentTabs[FORBIDDEN_TALENTS_IN_1V1_ARENA[i]].forbidden = true;
+
+    return talentTabs;
+}
+
+// TalentTabID -> role and forbidden flag, generated at compile time from the lists above
+constexpr std::array<Solo3v3TalentTabInfo, SOLO_3V3_TALENT_TAB_COUNT> SOLO_3V3_TALENT_TABS = BuildSolo3v3TalentTabs();
+
+// Talent points spent in the active spec, per role and in forbidden talent trees
+struct Solo3v3TalentPoints
+{
+    uint32 talentCat[MAX_TALENT_CAT] = { };
+    uint32 forbidden = 0;
+};
+
 #define BG_TEAMS_COUNT 2
 
+// Snapshot of a queued solo group, taken before the selection so the queue lists stay untouched until a match is committed
+struct Solo3v3Candidate
+{
+    GroupQueueInfo* group;
+    BattlegroundQueue::GroupsQueueType::iterator itr; // position in m_QueuedGroups[bracket][queueIndex], set by RevalidateSolo3v3Candidate
+    ObjectGuid playerGuid;
+    uint8 queueIndex;
+    Solo3v3TalentCat role;
+    uint32 mmr;
+    uint32 waitTime; // ms
+};
+
+typedef std::array<std::vector<Solo3v3Candidate const*>, BG_TEAMS_COUNT> Solo3v3MatchSelection;
+
+// Snapshot positions of the MELEE, RANGE and HEALER candidates, each ordered by MMR
+typedef std::array<std::vector<uint32>, HEALER + 1> Solo3v3MMROrder;
+
+// Settings of a match selection, read on the world thread so the selection itself reads no global state
+struct Solo3v3MatchSettings
+{
+    uint32 MinPlayersPerTeam = 3; // 1 while arena testing (.debug arena) is on
+    uint32 MMRWindow = 0;
+    uint32 MMRWindowGrowth = 0;
+    uint32 MMRWindowGrowthInterval = 0;
+    uint32 MMRWindowMax = 0;
+
+    bool UsesMMRWindow(bool isRated) const { return isRated && MinPlayersPerTeam == 3 && MMRWindow > 0; }
+};
+
+constexpr uint8 SOLO_3V3_MATCH_PLAYERS = 6;
+constexpr uint8 SOLO_3V3_TEAM_SPLIT_COUNT = 10;
+
+// Every 3/3 split of the 6 players of a match, as bitmask of the players on the first team.
+// The first player is always on the first team, so mirrored splits are skipped.
+constexpr std::array<uint8, SOLO_3V3_TEAM_SPLIT_COUNT> BuildSolo3v3TeamSplits()
+{
+    std::array<uint8, SOLO_3V3_TEAM_SPLIT_COUNT> splits{};
+    uint8 count = 0;
+
+    for (uint8 mask = 1; mask < (1 << SOLO_3V3_MATCH_PLAYERS); mask += 2)
+    {
+        uint8 players = 0;
+        for (uint8 i = 0; i < SOLO_3V3_MATCH_PLAYERS; ++i)
+            players += (mask >> i) & 1;
+
+        if (players == SOLO_3V3_MATCH_PLAYERS / 2)
+            splits[count++] = mask;
+    }
+
+    return splits;
+}
+
+constexpr std::array<uint8, SOLO_3V3_TEAM_SPLIT_COUNT> SOLO_3V3_TEAM_SPLITS = BuildSolo3v3TeamSplits();
+
+struct Solo3v3TeamComposition
+{
+    int healerCount = 0, meleeCount = 0, rangedCount = 0;
+    int getTotalPlayers() const { return healerCount + meleeCount + rangedCount; }
+    int getTotalDPS() const { return meleeCount + rangedCount; }
+
+    // At most one player per role, whatever MeleeCasterHealer is set to. The original check misnested its
+    // if/else so the melee/caster/healer limits always applied, and live matchmaking keeps that behaviour.
+    bool canAddPlayer(Solo3v3TalentCat role) const
+    {
+        if (getTotalPlayers() >= 3)
+            return false;
+
+        if (role == HEALER)
+            return healerCount < 1;
+
+        if (role == MELEE)
+            return meleeCount < 1;
+
+        return rangedCount < 1;
+    }
+
+    void addPlayer(Solo3v3TalentCat role)
+    {
+        if (role == HEALER) healerCount++;
+        else if (role == MELEE) meleeCount++;
+        else if (role == RANGE) rangedCount++;
+    }
+
+    // Same rule as canAddPlayer, one player of each role
+    bool isValidComposition() const
+    {
+        return healerCount == 1 && meleeCount == 1 && rangedCount == 1;
+    }
+};
+
+// Talent category per spec, MAX_TALENT_CAT while not computed yet
+struct Solo3v3TalentCatCacheEntry
+{
+    Solo3v3TalentCat talentCat[MAX_TALENT_SPECS] = { MAX_TALENT_CAT, MAX_TALENT_CAT };
+};
+
 class Solo3v3
 {
 public:
     static Solo3v3* instance();
 
-    uint32 GetAverageMMR(ArenaTeam* team);
+    uint32 GetAverageMMR(ArenaTeam* team, BattlegroundQueue::GroupsQueueType const& groups);
     void CheckStartSolo3v3Arena(Battleground* bg);
     void CleanUp3v3SoloQ(Battleground* bg);
-    bool CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated);
+
+    // Selects the next match of the bracket into the selection pools. Selected players that are no longer queued
+    // are dropped from the index and the selection is retried; when the matchmaking budget runs out between
+    // retries it returns false with deferred set, and the pruning done so far carries over to the next tick.
+    bool CheckSolo3v3Arena(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated, bool& deferred);
     void CreateTempArenaTeamForQueue(BattlegroundQueue* queue, ArenaTeam* arenaTeams[]);
     void CountAsLoss(Player* player, bool isInProgress);
 
+    // Collects the not invited players of the bracket from the queue index, in join order, and their MMR order
+    // if asked for. The queue iterators are only set once the candidates are revalidated.
+    void BuildSolo3v3Candidates(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated, std::vector<Solo3v3Candidate>& candidates, Solo3v3MMROrder* mmrOrder = nullptr);
+
+    // World thread. Arena testing state and the matchmaking config for SelectSolo3v3Match.
+    Solo3v3MatchSettings GetMatchSettings();
+
+    // Only reads the candidates and the settings, so it can run on a snapshot outside of the world thread.
+    // rng replaces urand for the random team picks, for deterministic replays. Without mmrOrder the MMR window
+    // selection sorts the candidates itself.
+    bool SelectSolo3v3Match(std::vector<Solo3v3Candidate> const& candidates, bool isRated, Solo3v3MatchSettings const& settings, Solo3v3MatchSelection& selected,
+        std::mt19937* rng = nullptr, Solo3v3MMROrder const* mmrOrder = nullptr);
+
+    // Sorts the candidates of each role by MMR, for snapshots that don't come from the queue index
+    void BuildSolo3v3MMROrder(std::vector<Solo3v3Candidate> const& candidates, Solo3v3MMROrder& mmrOrder);
+
+    // Moves the selected groups to their team list and fills the selection pools
+    void CommitSolo3v3Match(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, bool isRated, Solo3v3MatchSelection const& selected);
+
+    // Checks that a candidate of an older snapshot is still queued and not invited, and refreshes its iterator.
+    // A lookup in the queue player map and the index, no walk over the faction lists.
+    bool RevalidateSolo3v3Candidate(BattlegroundQueue* queue, BattlegroundBracketId bracket_id, Solo3v3Candidate& candidate);
+
     // Return false, if player have invested more than 35 talentpoints in a forbidden talenttree.
     bool Arena3v3CheckTalents(Player* player);
 
     // Returns MELEE, RANGE or HEALER (depends on talent builds)
     Solo3v3TalentCat GetTalentCatForSolo3v3(Player* player);
+
+    // Same as GetTalentCatForSolo3v3, but only scans the talents once per player and active spec
+    Solo3v3TalentCat GetCachedTalentCat(Player* player);
+    void InvalidateTalentCat(ObjectGuid guid);
+
+    // Reclassifies a queued player after a talent change, so the matcher doesn't use the role of the join
+    void RefreshQueuedRole(Player* player);
+
+private:
+    // Fills the teams in queue order
+    bool SelectSolo3v3MatchInQueueOrder(std::vector<Solo3v3Candidate> const& candidates, uint32 MinPlayersPerTeam, Solo3v3MatchSelection& selected, std::mt19937* rng);
+
+    // Only matches players inside an MMR window around the longest waiting player, the window widens with its wait time.
+    // Each anchor costs a binary search per role, the first one with two players of every role inside its window
+    // forms the match after a walk over that window.
+    bool SelectSolo3v3MatchByMMR(std::vector<Solo3v3Candidate> const& candidates, Solo3v3MatchSettings const& settings, Solo3v3MMROrder const& mmrOrder, Solo3v3MatchSelection& selected);
+
+    // Picks the role valid 3/3 split of the 6 chosen players with the smallest MMR gap between the teams
+    bool SplitSolo3v3Teams(std::vector<Solo3v3Candidate const*> const& chosen, Solo3v3MatchSelection& selected);
+
+    // Single pass over the learned talents of the active spec, shared by the role and forbidden talent checks
+    Solo3v3TalentPoints CountTalentPoints(Player* player);
+
+    std::unordered_map<ObjectGuid, Solo3v3TalentCatCacheEntry> talentCatCache;
+    std::mutex talentCatCacheLock;
 };
 
 #define sSolo Solo3v3::instance()
@@ -0,0 +1,135 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_bench.h"
+#include "solo3v3.h"
+#include "solo3v3_config.h"
+#include "solo3v3_queue_counters.h"
+#include "solo3v3_rank.h"
+#include "solo3v3_simulator.h"
+#include "solo3v3_sc.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+
+namespace
+{
+    // keeps the compiler from dropping the benchmarked calls
+    volatile uint32 benchSink;
+
+    Solo3v3BenchResult Measure(std::string const& name, uint32 iterations, std::function<void()> const& body)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint32 i = 0; i < iterations; ++i)
+            body();
+
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return { name, iterations, elapsed / iterations };
+    }
+}
+
+std::vector<Solo3v3BenchResult> Solo3v3Bench::Run(Player* player, uint32 iterations)
+{
+    std::vector<Solo3v3BenchResult> results;
+
+    if (player)
+    {
+        results.push_back(Measure("role_classification", iterations, [player]() { benchSink = sSolo->GetTalentCatForSolo3v3(player); }));
+        results.push_back(Measure("role_classification_cached", iterations, [player]() { benchSink = sSolo->GetCachedTalentCat(player); }));
+
+        // Arena3v3CheckTalents messages the player when it fails, only measure it on a valid build
+        if (sSolo->Arena3v3CheckTalents(player))
+            results.push_back(Measure("talent_validation", iterations, [player]() { benchSink = sSolo->Arena3v3CheckTalents(player); }));
+    }
+
+    // one match selection over a fixed queue, all players waited a minute. A selection scans the whole queue
+    // (and sorts it with MMR banding), so the bigger queues run fewer iterations to keep the world thread stall short.
+    constexpr uint32 SELECT_MATCH_CANDIDATE_BUDGET = 1000000;
+    Solo3v3SimulationSettings settings;
+    Solo3v3MatchSettings matchSettings = sSolo->GetMatchSettings();
+
+    for (uint32 queued : { 10, 100, 1000 })
+    {
+        std::mt19937 rng(settings.seed);
+        std::vector<Solo3v3Candidate> candidates;
+
+        for (uint32 i = 0; i < queued; ++i)
+        {
+            Solo3v3Candidate candidate = Solo3v3Simulator::MakeCandidate(settings, rng);
+            candidate.queueIndex = i % BG_TEAMS_COUNT;
+            candidate.waitTime = MINUTE * IN_MILLISECONDS;
+            candidates.push_back(candidate);
+        }
+
+        uint32 selectIterations = std::max(1u, std::min(iterations, SELECT_MATCH_CANDIDATE_BUDGET / queued));
+
+        results.push_back(Measure("select_match/" + std::to_string(queued), selectIterations, [&candidates, &settings, &matchSettings]()
+        {
+            Solo3v3MatchSelection selected;
+            benchSink = sSolo->SelectSolo3v3Match(candidates, settings.isRated, matchSettings, selected);
+        }));
+    }
+
+    results.push_back(Measure("rank/0-3000", iterations, []()
+    {
+        for (uint32 rating = 0; rating <= 3000; rating += 100)
+            benchSink = sSolo3v3Rank->GetRank(rating);
+    }));
+
+    // the gossip queue header as built on a counter change, the counts and the text
+    bool MeleeCasterHealer = sSolo3v3Config.MeleeCasterHealer;
+    results.push_back(Measure("queue_info_render", iterations, [MeleeCasterHealer]()
+    {
+        benchSink = NpcSolo3v3::RenderQueueInfo(MeleeCasterHealer, sSolo3v3QueueCounters->GetCounts()).size();
+    }));
+
+    return results;
+}
+
+bool Solo3v3Bench::WriteJson(std::vector<Solo3v3BenchResult> const& results, std::string const& fileName)
+{
+    std::ofstream file(fileName, std::ios::trunc);
+    if (!file)
+        return false;
+
+    Solo3v3Config const& config = sSolo3v3Config;
+
+    file << "{\n";
+    file << "  \"context\": {\n";
+    file << "    \"module\": \"mod-arena-3v3-solo-queue\",\n";
+    file << "    \"mmr_window\": " << config.MMRWindow << ",\n";
+    file << "    \"melee_caster_healer\": " << (config.MeleeCasterHealer ? "true" : "false") << "\n";
+    file << "  },\n";
+    file << "  \"benchmarks\": [\n";
+
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        file << "    {\n";
+        file << "      \"name\": \"" << results[i].name << "\",\n";
+        file << "      \"iterations\": " << results[i].iterations << ",\n";
+        file << "      \"real_time\": " << results[i].nsPerIteration << ",\n";
+        file << "      \"time_unit\": \"ns\"\n";
+        file << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+
+    return true;
+}
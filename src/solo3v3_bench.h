@@ -0,0 +1,45 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_BENCH_H_
+#define _SOLO_3V3_BENCH_H_
+
+#include "Common.h"
+#include <string>
+#include <vector>
+
+class Player;
+
+struct Solo3v3BenchResult
+{
+    std::string name;
+    uint32 iterations;
+    double nsPerIteration;
+};
+
+// Micro benchmarks of the solo queue hot paths on fixed fixtures (seeded candidates, fixed rating list).
+// The role and talent checks run on the given player, they are skipped without one.
+class Solo3v3Bench
+{
+public:
+    static std::vector<Solo3v3BenchResult> Run(Player* player, uint32 iterations);
+
+    // Same layout as the Google Benchmark JSON output, so results of two builds can be diffed
+    static bool WriteJson(std::vector<Solo3v3BenchResult> const& results, std::string const& fileName);
+};
+
+#endif // _SOLO_3V3_BENCH_H_
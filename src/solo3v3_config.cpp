@@ -0,0 +1,80 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_config.h"
+#include "Config.h"
+
+Solo3v3ConfigMgr::Solo3v3ConfigMgr()
+{
+    active = std::make_unique<Solo3v3Config const>();
+    current.store(active.get(), std::memory_order_release);
+}
+
+Solo3v3ConfigMgr* Solo3v3ConfigMgr::instance()
+{
+    static Solo3v3ConfigMgr instance;
+    return &instance;
+}
+
+void Solo3v3ConfigMgr::Load()
+{
+    std::unique_ptr<Solo3v3Config> config = std::make_unique<Solo3v3Config>();
+
+    config->Enable = sConfigMgr->GetOption<bool>("Solo.3v3.Enable", true);
+    config->EnableCommand = sConfigMgr->GetOption<bool>("Solo.3v3.EnableCommand", true);
+    config->EnableTestingCommand = sConfigMgr->GetOption<bool>("Solo.3v3.EnableTestingCommand", true);
+    config->MeleeCasterHealer = sConfigMgr->GetOption<bool>("Solo.3v3.MeleeCasterHealer", false);
+    config->CheckEquipAndTalents = sConfigMgr->GetOption<bool>("Arena.CheckEquipAndTalents", true);
+    config->BlockForbiddenTalents = sConfigMgr->GetOption<bool>("Arena.3v3.BlockForbiddenTalents", false);
+    config->CastDeserterOnAfk = sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true);
+    config->CastDeserterOnLeave = sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true);
+    config->StopGameIncomplete = sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true);
+    config->RatingPenaltyLeaveDuringMatch = sConfigMgr->GetOption<int32>("Solo.3v3.RatingPenalty.LeaveDuringMatch", 24);
+    config->RatingPenaltyLeaveBeforeMatchStart = sConfigMgr->GetOption<int32>("Solo.3v3.RatingPenalty.LeaveBeforeMatchStart", 50);
+    config->MinLevel = sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 80);
+    config->Cost = sConfigMgr->GetOption<uint32>("Solo.3v3.Cost", 1);
+    config->ArenaPointsMulti = sConfigMgr->GetOption<float>("Solo.3v3.ArenaPointsMulti", 0.8f);
+    config->ArenaPointsMinLevel = sConfigMgr->GetOption<uint32>("Solo.3v3.ArenaPointsMinLevel", 70);
+    config->VendorRating = sConfigMgr->GetOption<bool>("Solo.3v3.VendorRating", true);
+    config->ShowMessageOnLogin = sConfigMgr->GetOption<bool>("Solo.3v3.ShowMessageOnLogin", false);
+    config->ShowTeamInfo = sConfigMgr->GetOption<bool>("Solo.3v3.ShowTeamInfo", true);
+
+    config->MaxArenasPerQueueUpdate = sConfigMgr->GetOption<uint32>("Solo.3v3.MaxArenasPerQueueUpdate", 0);
+    config->MMRWindow = sConfigMgr->GetOption<uint32>("Solo.3v3.Matchmaking.MMRWindow", 0);
+    config->MMRWindowGrowth = sConfigMgr->GetOption<uint32>("Solo.3v3.Matchmaking.MMRWindowGrowth", 100);
+    config->MMRWindowGrowthInterval = sConfigMgr->GetOption<uint32>("Solo.3v3.Matchmaking.MMRWindowGrowthInterval", 30) * IN_MILLISECONDS;
+    config->MMRWindowMax = sConfigMgr->GetOption<uint32>("Solo.3v3.Matchmaking.MMRWindowMax", 0);
+    config->QueueUpdateInterval = sConfigMgr->GetOption<uint32>("Solo.3v3.Matchmaking.QueueUpdateInterval", 5000);
+    config->MatchmakingTimeBudget = sConfigMgr->GetOption<uint32>("Solo.3v3.Matchmaking.TimeBudget", 0);
+    config->LatencyReportInterval = sConfigMgr->GetOption<uint32>("Solo.3v3.Matchmaking.LatencyReportInterval", 300) * IN_MILLISECONDS;
+    config->MatchmakingWorkerThreads = sConfigMgr->GetOption<uint32>("Solo.3v3.Matchmaking.WorkerThreads", 0);
+
+    config->WaitStatsHalfLife = sConfigMgr->GetOption<uint32>("Solo.3v3.WaitStats.HalfLife", 1800) * IN_MILLISECONDS;
+
+    config->TraceEnable = sConfigMgr->GetOption<bool>("Solo.3v3.Trace.Enable", false);
+    config->TraceFile = sConfigMgr->GetOption<std::string>("Solo.3v3.Trace.File", "solo3v3_trace.bin");
+
+    config->SaveInterval = sConfigMgr->GetOption<uint32>("Solo.3v3.SaveInterval", 10000);
+    config->SaveBatchSize = sConfigMgr->GetOption<uint32>("Solo.3v3.SaveBatchSize", 60);
+
+    std::lock_guard<std::mutex> guard(loadLock);
+    current.store(config.get(), std::memory_order_release);
+
+    // the snapshot replaced by the previous reload is freed here
+    retired = std::move(active);
+    active = std::move(config);
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_CONFIG_H_
+#define _SOLO_3V3_CONFIG_H_
+
+#include "Common.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Typed solo 3v3 settings, read once per config (re)load
+struct Solo3v3Config
+{
+    bool Enable = true;
+    bool EnableCommand = true;
+    bool EnableTestingCommand = true;
+    bool MeleeCasterHealer = false;
+    bool CheckEquipAndTalents = true;        // Arena.CheckEquipAndTalents
+    bool BlockForbiddenTalents = false;      // Arena.3v3.BlockForbiddenTalents
+    bool CastDeserterOnAfk = true;
+    bool CastDeserterOnLeave = true;
+    bool StopGameIncomplete = true;
+    int32 RatingPenaltyLeaveDuringMatch = 24;
+    int32 RatingPenaltyLeaveBeforeMatchStart = 50;
+    uint32 MinLevel = 80;
+    uint32 Cost = 1;
+    float ArenaPointsMulti = 0.8f;
+    uint32 ArenaPointsMinLevel = 70;
+    bool VendorRating = true;
+    bool ShowMessageOnLogin = false;
+    bool ShowTeamInfo = true;
+
+    uint32 MaxArenasPerQueueUpdate = 0;
+    uint32 MMRWindow = 0;
+    uint32 MMRWindowGrowth = 100;
+    uint32 MMRWindowGrowthInterval = 30 * IN_MILLISECONDS;
+    uint32 MMRWindowMax = 0;
+    uint32 QueueUpdateInterval = 5000;
+    uint32 MatchmakingTimeBudget = 0; // us
+    uint32 LatencyReportInterval = 300 * IN_MILLISECONDS;
+    uint32 MatchmakingWorkerThreads = 0;
+
+    uint32 WaitStatsHalfLife = 1800 * IN_MILLISECONDS;
+
+    bool TraceEnable = false;
+    std::string TraceFile = "solo3v3_trace.bin";
+
+    uint32 SaveInterval = 10000;
+    uint32 SaveBatchSize = 60;
+
+    // deserter is cast on leave for both options
+    bool CastDeserter() const { return CastDeserterOnAfk || CastDeserterOnLeave; }
+};
+
+// Holds the current settings snapshot. A reload builds a new snapshot and swaps the pointer,
+// so readers always see either the old or the new settings, never a mix of both, and a read is a plain field read.
+// Readers only keep a snapshot for the length of a hook, so the replaced one is freed on the reload after.
+class Solo3v3ConfigMgr
+{
+public:
+    static Solo3v3ConfigMgr* instance();
+
+    // World thread (config load and reload)
+    void Load();
+    Solo3v3Config const& Get() const { return *current.load(std::memory_order_acquire); }
+
+private:
+    Solo3v3ConfigMgr();
+
+    std::atomic<Solo3v3Config const*> current;
+    std::unique_ptr<Solo3v3Config const> active;  // owns current
+    std::unique_ptr<Solo3v3Config const> retired; // replaced by the last reload
+    std::mutex loadLock;
+};
+
+#define sSolo3v3Config Solo3v3ConfigMgr::instance()->Get()
+
+#endif // _SOLO_3V3_CONFIG_H_
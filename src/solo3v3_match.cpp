@@ -0,0 +1,57 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_match.h"
+
+Solo3v3MatchStore* Solo3v3MatchStore::instance()
+{
+    static Solo3v3MatchStore instance;
+    return &instance;
+}
+
+void Solo3v3MatchStore::Add(uint32 instanceId, uint32 allianceRating, uint32 hordeRating)
+{
+    Shard& shard = GetShard(instanceId);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    Solo3v3MatchContext& context = shard.matches[instanceId];
+    context.allianceRating = allianceRating;
+    context.hordeRating = hordeRating;
+}
+
+bool Solo3v3MatchStore::Take(uint32 instanceId, Solo3v3MatchContext& context)
+{
+    Shard& shard = GetShard(instanceId);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto itr = shard.matches.find(instanceId);
+    if (itr == shard.matches.end())
+        return false;
+
+    context = itr->second;
+    shard.matches.erase(itr);
+
+    return true;
+}
+
+void Solo3v3MatchStore::Remove(uint32 instanceId)
+{
+    Shard& shard = GetShard(instanceId);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    shard.matches.erase(instanceId);
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_MATCH_H_
+#define _SOLO_3V3_MATCH_H_
+
+#include "Common.h"
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
+// Team ratings of a running rated solo match, taken when the match is created
+struct Solo3v3MatchContext
+{
+    uint32 allianceRating = 0;
+    uint32 hordeRating = 0;
+};
+
+// Match contexts by battleground instance id. The end reward hook runs on the map update threads,
+// so the store is split in shards with their own lock and arenas ending at once rarely wait on each other.
+class Solo3v3MatchStore
+{
+public:
+    static Solo3v3MatchStore* instance();
+
+    void Add(uint32 instanceId, uint32 allianceRating, uint32 hordeRating);
+
+    // Moves the context out of the store, returns false if there is none (already settled or not rated)
+    bool Take(uint32 instanceId, Solo3v3MatchContext& context);
+
+    void Remove(uint32 instanceId);
+
+private:
+    static constexpr uint32 SHARD_COUNT = 16;
+
+    struct Shard
+    {
+        std::unordered_map<uint32, Solo3v3MatchContext> matches;
+        std::mutex lock;
+    };
+
+    Shard& GetShard(uint32 instanceId) { return shards[instanceId % SHARD_COUNT]; }
+
+    std::array<Shard, SHARD_COUNT> shards;
+};
+
+#define sSolo3v3Matches Solo3v3MatchStore::instance()
+
+#endif // _SOLO_3V3_MATCH_H_
@@ -0,0 +1,99 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_matchmaker.h"
+#include "solo3v3_config.h"
+#include "Log.h"
+#include <algorithm>
+
+Solo3v3MatchmakerTimer* Solo3v3MatchmakerTimer::instance()
+{
+    static Solo3v3MatchmakerTimer instance;
+    return &instance;
+}
+
+void Solo3v3MatchmakerTimer::Begin(BattlegroundBracketId bracket_id, bool isRated)
+{
+    updateStart = std::chrono::steady_clock::now();
+    budget = sSolo3v3Config.MatchmakingTimeBudget;
+
+    currentPass = &passes[bracket_id][isRated ? 1 : 0];
+    currentPass->ticks += 1;
+}
+
+bool Solo3v3MatchmakerTimer::BudgetExceeded() const
+{
+    if (!budget)
+        return false;
+
+    return std::chrono::steady_clock::now() - updateStart >= std::chrono::microseconds(budget);
+}
+
+void Solo3v3MatchmakerTimer::End(uint32 arenasCreated, bool finished)
+{
+    uint32 elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - updateStart).count();
+
+    latencies[latencyIndex] = elapsed;
+    latencyIndex = (latencyIndex + 1) % LATENCY_SAMPLES;
+    latencyCount = std::min(latencyCount + 1, LATENCY_SAMPLES);
+
+    if (!currentPass)
+        return;
+
+    if (currentPass->pending)
+        ++resumedUpdates;
+
+    currentPass->arenas += arenasCreated;
+    currentPass->pending = !finished;
+
+    if (finished)
+    {
+        maxPassTicks = std::max(maxPassTicks, currentPass->ticks);
+        *currentPass = PassState();
+    }
+
+    currentPass = nullptr;
+}
+
+void Solo3v3MatchmakerTimer::Update(uint32 diff)
+{
+    uint32 interval = sSolo3v3Config.LatencyReportInterval;
+    if (!interval)
+        return;
+
+    reportTimer += diff;
+    if (reportTimer < interval)
+        return;
+
+    reportTimer = 0;
+
+    if (!latencyCount)
+        return;
+
+    std::array<uint32, LATENCY_SAMPLES> sorted = latencies;
+    std::sort(sorted.begin(), sorted.begin() + latencyCount);
+
+    uint32 p50 = sorted[latencyCount / 2];
+    uint32 p99 = sorted[std::min(latencyCount - 1, latencyCount * 99 / 100)];
+    uint32 max = sorted[latencyCount - 1];
+
+    LOG_INFO("module", "Solo 3v3 queue updates (last {}): p50 {} us, p99 {} us, max {} us, {} resumed, longest pass {} ticks",
+        latencyCount, p50, p99, max, resumedUpdates, maxPassTicks);
+
+    resumedUpdates = 0;
+    maxPassTicks = 0;
+}
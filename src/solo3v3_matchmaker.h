@@ -0,0 +1,78 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_MATCHMAKER_H_
+#define _SOLO_3V3_MATCHMAKER_H_
+
+#include "Common.h"
+#include "DBCEnums.h"
+#include <array>
+#include <chrono>
+
+// Time budget and latency of the solo queue updates. A queue update stops forming matches once the
+// per tick budget is used up and resumes on the next world tick, so big queues don't cause update spikes.
+// The budget is checked after each arena and between the revalidation retries of a selection, so the work
+// done past the budget is at most one snapshot plus one selection, O(n) in queue order and O(n log n) with
+// MMR banding. The state kept between ticks is the queue itself (formed matches have left it) and the
+// index, which keeps the stale entries pruned before the deferral.
+// With worker threads the selection runs off the world thread, and the budget and the latency samples
+// cover the commit of the selected matches in Solo3v3QueueScheduler::CommitWorkerMatches instead.
+// Queue updates and world scripts run on the world thread, so there is no locking.
+class Solo3v3MatchmakerTimer
+{
+public:
+    static Solo3v3MatchmakerTimer* instance();
+
+    void Begin(BattlegroundBracketId bracket_id, bool isRated);
+
+    // At least one match is formed per update, so a pass always ends within a bounded number of ticks
+    bool BudgetExceeded() const;
+
+    // finished is false if the update stopped on the budget and was scheduled again for the next tick
+    void End(uint32 arenasCreated, bool finished);
+
+    // Logs the tail latency of the queue updates every Solo.3v3.Matchmaking.LatencyReportInterval
+    void Update(uint32 diff);
+
+private:
+    // a matching pass over a bracket, may span several ticks
+    struct PassState
+    {
+        bool pending = false;
+        uint32 ticks = 0;
+        uint32 arenas = 0;
+    };
+
+    static constexpr uint32 LATENCY_SAMPLES = 512;
+
+    std::array<std::array<PassState, 2>, MAX_BATTLEGROUND_BRACKETS> passes;
+    PassState* currentPass = nullptr;
+    std::chrono::steady_clock::time_point updateStart;
+    uint32 budget = 0;
+
+    // update durations in us, ring buffer
+    std::array<uint32, LATENCY_SAMPLES> latencies{};
+    uint32 latencyCount = 0;
+    uint32 latencyIndex = 0;
+    uint32 maxPassTicks = 0;
+    uint32 resumedUpdates = 0;
+    uint32 reportTimer = 0;
+};
+
+#define sSolo3v3Matchmaker Solo3v3MatchmakerTimer::instance()
+
+#endif // _SOLO_3V3_MATCHMAKER_H_
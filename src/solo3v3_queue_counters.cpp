@@ -0,0 +1,113 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_queue_counters.h"
+#include <algorithm>
+
+Solo3v3QueueCounters* Solo3v3QueueCounters::instance()
+{
+    static Solo3v3QueueCounters instance;
+    return &instance;
+}
+
+void Solo3v3QueueCounters::AddPlayer(Player* player, Solo3v3TalentCat role)
+{
+    QueuedPlayer queuedPlayer = { role, GetClassCat(player->getClass()) };
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto result = queuedPlayers.emplace(player->GetGUID(), queuedPlayer);
+    if (!result.second)
+        return;
+
+    Count(queuedPlayer, 1);
+}
+
+void Solo3v3QueueCounters::RemovePlayer(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto itr = queuedPlayers.find(guid);
+    if (itr == queuedPlayers.end())
+        return;
+
+    Count(itr->second, -1);
+    queuedPlayers.erase(itr);
+}
+
+void Solo3v3QueueCounters::UpdateRole(ObjectGuid guid, Solo3v3TalentCat role)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto itr = queuedPlayers.find(guid);
+    if (itr == queuedPlayers.end() || itr->second.role == role)
+        return;
+
+    Count(itr->second, -1);
+    itr->second.role = role;
+    Count(itr->second, 1);
+}
+
+Solo3v3QueueCounts Solo3v3QueueCounters::GetCounts() const
+{
+    Solo3v3QueueCounts counts;
+
+    for (uint32 i = 0; i < MAX_TALENT_CAT; ++i)
+        counts[i] = std::max<int32>(0, counters[i].load(std::memory_order_relaxed));
+
+    return counts;
+}
+
+Solo3v3TalentCat Solo3v3QueueCounters::GetClassCat(uint8 playerClass)
+{
+    switch (playerClass)
+    {
+        case CLASS_WARRIOR:
+            return WARRIOR;
+        case CLASS_PALADIN:
+            return PALADIN;
+        case CLASS_DEATH_KNIGHT:
+            return DK;
+        case CLASS_HUNTER:
+            return HUNTER;
+        case CLASS_SHAMAN:
+            return SHAMAN;
+        case CLASS_ROGUE:
+            return ROGUE;
+        case CLASS_DRUID:
+            return DRUID;
+        case CLASS_MAGE:
+            return MAGE;
+        case CLASS_WARLOCK:
+            return WARLOCK;
+        case CLASS_PRIEST:
+            return PRIEST;
+        default:
+            return MAX_TALENT_CAT;
+    }
+}
+
+void Solo3v3QueueCounters::Count(QueuedPlayer const& queuedPlayer, int32 count)
+{
+    if (queuedPlayer.role < MAX_TALENT_CAT)
+        counters[queuedPlayer.role].fetch_add(count, std::memory_order_relaxed);
+
+    if (queuedPlayer.classCat < MAX_TALENT_CAT)
+        counters[queuedPlayer.classCat].fetch_add(count, std::memory_order_relaxed);
+
+    version.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,69 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_QUEUE_COUNTERS_H_
+#define _SOLO_3V3_QUEUE_COUNTERS_H_
+
+#include "solo3v3.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+typedef std::array<uint32, MAX_TALENT_CAT> Solo3v3QueueCounts;
+
+// Number of queued (not yet invited) solo players per role and per class (MAGE..WARRIOR),
+// kept up to date on join, invite and leave so the battlemaster panel doesn't walk the queue.
+class Solo3v3QueueCounters
+{
+public:
+    static Solo3v3QueueCounters* instance();
+
+    void AddPlayer(Player* player, Solo3v3TalentCat role);
+
+    // Does nothing if the player isn't counted, so every leave path can call it
+    void RemovePlayer(ObjectGuid guid);
+
+    // Moves a counted player to the role of their new talents
+    void UpdateRole(ObjectGuid guid, Solo3v3TalentCat role);
+
+    Solo3v3QueueCounts GetCounts() const;
+
+    // Changes whenever a counter changes
+    uint32 GetVersion() const { return version.load(std::memory_order_acquire); }
+
+private:
+    struct QueuedPlayer
+    {
+        Solo3v3TalentCat role;
+        Solo3v3TalentCat classCat;
+    };
+
+    // MAX_TALENT_CAT for classes without a counter
+    static Solo3v3TalentCat GetClassCat(uint8 playerClass);
+
+    void Count(QueuedPlayer const& queuedPlayer, int32 count);
+
+    std::array<std::atomic<int32>, MAX_TALENT_CAT> counters{};
+    std::atomic<uint32> version{0};
+    std::unordered_map<ObjectGuid, QueuedPlayer> queuedPlayers;
+    std::mutex lock;
+};
+
+#define sSolo3v3QueueCounters Solo3v3QueueCounters::instance()
+
+#endif // _SOLO_3V3_QUEUE_COUNTERS_H_
@@ -0,0 +1,276 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_queue_index.h"
+#include <algorithm>
+#include <iterator>
+
+void Solo3v3QueueEntries::push_back(ObjectGuid guid, Player* player, GroupQueueInfo* group, uint8 role, uint8 playerClass, uint32 mmr, uint32 joinTime, uint8 queueIndex,
+    BattlegroundQueue::GroupsQueueType::iterator position)
+{
+    guids.push_back(guid);
+    players.push_back(player);
+    groups.push_back(group);
+    roles.push_back(role);
+    classes.push_back(playerClass);
+    mmrs.push_back(mmr);
+    joinTimes.push_back(joinTime);
+    queueIndexes.push_back(queueIndex);
+    positions.push_back(position);
+    active.push_back(1);
+}
+
+void Solo3v3QueueEntries::compact()
+{
+    uint32 count = 0;
+
+    for (uint32 i = 0; i < size(); ++i)
+    {
+        if (!active[i])
+            continue;
+
+        guids[count] = guids[i];
+        players[count] = players[i];
+        groups[count] = groups[i];
+        roles[count] = roles[i];
+        classes[count] = classes[i];
+        mmrs[count] = mmrs[i];
+        joinTimes[count] = joinTimes[i];
+        queueIndexes[count] = queueIndexes[i];
+        positions[count] = positions[i];
+        active[count] = 1;
+        ++count;
+    }
+
+    guids.resize(count);
+    players.resize(count);
+    groups.resize(count);
+    roles.resize(count);
+    classes.resize(count);
+    mmrs.resize(count);
+    joinTimes.resize(count);
+    queueIndexes.resize(count);
+    positions.resize(count);
+    active.resize(count);
+    removed = 0;
+}
+
+Solo3v3QueueIndex* Solo3v3QueueIndex::instance()
+{
+    static Solo3v3QueueIndex instance;
+    return &instance;
+}
+
+void Solo3v3QueueIndex::AddPlayer(BattlegroundQueue* queue, Player* player, GroupQueueInfo* ginfo, BattlegroundBracketId bracket_id, bool isRated, Solo3v3TalentCat role)
+{
+    uint8 rated = isRated ? 1 : 0;
+    uint8 queueIndex = (isRated ? BG_QUEUE_PREMADE_ALLIANCE : BG_QUEUE_NORMAL_ALLIANCE) + (ginfo->teamId == TEAM_HORDE ? 1 : 0);
+
+    // AddGroup appends the group to its faction list, only search the list if that ever changes
+    BattlegroundQueue::GroupsQueueType& groups = queue->m_QueuedGroups[bracket_id][queueIndex];
+    BattlegroundQueue::GroupsQueueType::iterator position;
+    if (!groups.empty() && groups.back() == ginfo)
+        position = std::prev(groups.end());
+    else
+        position = std::find(groups.begin(), groups.end(), ginfo);
+
+    if (position == groups.end())
+        return;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    // left through a path the index didn't see and joined again, the old group is gone
+    auto itr = slots.find(player->GetGUID());
+    if (itr != slots.end())
+    {
+        EntrySlot oldSlot = itr->second;
+        slots.erase(itr);
+        Deactivate(oldSlot);
+    }
+
+    Solo3v3QueueEntries& bracketEntries = entries[bracket_id][rated];
+    slots[player->GetGUID()] = { bracket_id, rated, bracketEntries.size() };
+    bracketEntries.push_back(player->GetGUID(), player, ginfo, role, player->getClass(), ginfo->ArenaMatchmakerRating, ginfo->JoinTime, queueIndex, position);
+
+    if (role <= HEALER)
+        mmrOrders[bracket_id][rated][role].emplace(ginfo->ArenaMatchmakerRating, player->GetGUID());
+}
+
+bool Solo3v3QueueIndex::RemovePlayer(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto itr = slots.find(guid);
+    if (itr == slots.end())
+        return false;
+
+    EntrySlot entrySlot = itr->second;
+    slots.erase(itr);
+    Deactivate(entrySlot);
+
+    return true;
+}
+
+void Solo3v3QueueIndex::Deactivate(EntrySlot const& entrySlot)
+{
+    Solo3v3QueueEntries& bracketEntries = entries[entrySlot.bracket_id][entrySlot.rated];
+
+    uint8 role = bracketEntries.roles[entrySlot.slot];
+    if (role <= HEALER)
+        mmrOrders[entrySlot.bracket_id][entrySlot.rated][role].erase({ bracketEntries.mmrs[entrySlot.slot], bracketEntries.guids[entrySlot.slot] });
+
+    bracketEntries.active[entrySlot.slot] = 0;
+    bracketEntries.players[entrySlot.slot] = nullptr;
+    bracketEntries.removed += 1;
+
+    if (bracketEntries.removed * 2 < bracketEntries.size())
+        return;
+
+    bracketEntries.compact();
+
+    for (uint32 i = 0; i < bracketEntries.size(); ++i)
+        slots[bracketEntries.guids[i]].slot = i;
+}
+
+Player* Solo3v3QueueIndex::GetPlayer(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto itr = slots.find(guid);
+    if (itr == slots.end())
+        return nullptr;
+
+    return entries[itr->second.bracket_id][itr->second.rated].players[itr->second.slot];
+}
+
+Solo3v3TalentCat Solo3v3QueueIndex::GetRole(ObjectGuid guid)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto itr = slots.find(guid);
+    if (itr == slots.end())
+        return MAX_TALENT_CAT;
+
+    return Solo3v3TalentCat(entries[itr->second.bracket_id][itr->second.rated].roles[itr->second.slot]);
+}
+
+void Solo3v3QueueIndex::UpdateRole(ObjectGuid guid, Solo3v3TalentCat role)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto itr = slots.find(guid);
+    if (itr == slots.end())
+        return;
+
+    Solo3v3QueueEntries& bracketEntries = entries[itr->second.bracket_id][itr->second.rated];
+    uint8 oldRole = bracketEntries.roles[itr->second.slot];
+    if (oldRole == role)
+        return;
+
+    bracketEntries.roles[itr->second.slot] = role;
+
+    MMROrder& mmrOrder = mmrOrders[itr->second.bracket_id][itr->second.rated];
+    std::pair<uint32, ObjectGuid> key(bracketEntries.mmrs[itr->second.slot], guid);
+
+    if (oldRole <= HEALER)
+        mmrOrder[oldRole].erase(key);
+
+    if (role <= HEALER)
+        mmrOrder[role].insert(key);
+}
+
+bool Solo3v3QueueIndex::GetQueuePosition(ObjectGuid guid, GroupQueueInfo const* group, uint8& queueIndex, BattlegroundQueue::GroupsQueueType::iterator& position)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto itr = slots.find(guid);
+    if (itr == slots.end())
+        return false;
+
+    Solo3v3QueueEntries const& bracketEntries = entries[itr->second.bracket_id][itr->second.rated];
+    if (bracketEntries.groups[itr->second.slot] != group)
+        return false;
+
+    queueIndex = bracketEntries.queueIndexes[itr->second.slot];
+    position = bracketEntries.positions[itr->second.slot];
+    return true;
+}
+
+void Solo3v3QueueIndex::SetQueuePosition(ObjectGuid guid, uint8 queueIndex, BattlegroundQueue::GroupsQueueType::iterator position)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto itr = slots.find(guid);
+    if (itr == slots.end())
+        return;
+
+    Solo3v3QueueEntries& bracketEntries = entries[itr->second.bracket_id][itr->second.rated];
+    bracketEntries.queueIndexes[itr->second.slot] = queueIndex;
+    bracketEntries.positions[itr->second.slot] = position;
+}
+
+void Solo3v3QueueIndex::BuildCandidates(BattlegroundBracketId bracket_id, bool isRated, uint32 now, std::vector<Solo3v3Candidate>& candidates, Solo3v3MMROrder* mmrOrder)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    Solo3v3QueueEntries const& bracketEntries = entries[bracket_id][isRated ? 1 : 0];
+    uint32 count = bracketEntries.size();
+
+    candidates.reserve(candidates.size() + count);
+
+    // snapshot position of each entry, for the MMR order
+    std::vector<uint32> positions;
+    if (mmrOrder)
+        positions.assign(count, UINT32_MAX);
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (!bracketEntries.active[i])
+            continue;
+
+        if (mmrOrder)
+            positions[i] = candidates.size();
+
+        Solo3v3Candidate candidate;
+        candidate.group = bracketEntries.groups[i];
+        candidate.playerGuid = bracketEntries.guids[i];
+        candidate.queueIndex = bracketEntries.queueIndexes[i];
+        candidate.role = Solo3v3TalentCat(bracketEntries.roles[i]);
+        candidate.mmr = bracketEntries.mmrs[i];
+        candidate.waitTime = GetMSTimeDiff(bracketEntries.joinTimes[i], now);
+        candidates.push_back(candidate);
+    }
+
+    if (!mmrOrder)
+        return;
+
+    MMROrder const& bracketOrder = mmrOrders[bracket_id][isRated ? 1 : 0];
+
+    for (uint8 role = MELEE; role <= HEALER; ++role)
+    {
+        std::vector<uint32>& rolePositions = (*mmrOrder)[role];
+        rolePositions.clear();
+        rolePositions.reserve(bracketOrder[role].size());
+
+        for (std::pair<uint32, ObjectGuid> const& entry : bracketOrder[role])
+        {
+            auto itr = slots.find(entry.second);
+            if (itr != slots.end() && positions[itr->second.slot] != UINT32_MAX)
+                rolePositions.push_back(positions[itr->second.slot]);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_QUEUE_INDEX_H_
+#define _SOLO_3V3_QUEUE_INDEX_H_
+
+#include "solo3v3.h"
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+// Queued solo players of a bracket, one array per field so the matcher scans them linearly
+struct Solo3v3QueueEntries
+{
+    std::vector<ObjectGuid> guids;
+    std::vector<Player*> players;        // cleared on logout and queue removal
+    std::vector<GroupQueueInfo*> groups; // only compared, never dereferenced before revalidation
+    std::vector<uint8> roles;
+    std::vector<uint8> classes;
+    std::vector<uint32> mmrs;
+    std::vector<uint32> joinTimes;
+    std::vector<uint8> queueIndexes;
+    std::vector<BattlegroundQueue::GroupsQueueType::iterator> positions; // in m_QueuedGroups[bracket][queueIndex], only used once the group is known to be queued
+    std::vector<uint8> active; // 0 once the player left or was invited, until the next compaction
+    uint32 removed = 0;
+
+    uint32 size() const { return guids.size(); }
+    void push_back(ObjectGuid guid, Player* player, GroupQueueInfo* group, uint8 role, uint8 playerClass, uint32 mmr, uint32 joinTime, uint8 queueIndex,
+        BattlegroundQueue::GroupsQueueType::iterator position);
+
+    // Drops the removed entries, keeping the join order
+    void compact();
+};
+
+// Module side mirror of the solo queue, kept in sync on join, leave and invite, so building the match
+// candidates needs no walk over the GroupQueueInfo lists and no player lookups. Entries stay in join order,
+// removals only clear the active flag and the arrays are compacted once half of them are removed.
+// The active players of each role are also kept ordered by MMR, for the MMR window selection.
+class Solo3v3QueueIndex
+{
+public:
+    static Solo3v3QueueIndex* instance();
+
+    // Called right after BattlegroundQueue::AddGroup, replaces a stale entry of the player
+    void AddPlayer(BattlegroundQueue* queue, Player* player, GroupQueueInfo* ginfo, BattlegroundBracketId bracket_id, bool isRated, Solo3v3TalentCat role);
+
+    // Does nothing and returns false if the player isn't in the index
+    bool RemovePlayer(ObjectGuid guid);
+
+    // Queued player without an ObjectAccessor lookup, nullptr if not in the index
+    Player* GetPlayer(ObjectGuid guid);
+
+    // Role the player was classified with on join or on the last talent change, MAX_TALENT_CAT if not in the index
+    Solo3v3TalentCat GetRole(ObjectGuid guid);
+
+    // Does nothing if the player isn't in the index
+    void UpdateRole(ObjectGuid guid, Solo3v3TalentCat role);
+
+    // Faction list and position of the player's group, false if the player isn't in the index with this group
+    bool GetQueuePosition(ObjectGuid guid, GroupQueueInfo const* group, uint8& queueIndex, BattlegroundQueue::GroupsQueueType::iterator& position);
+
+    // Called when the group is moved to the other faction list
+    void SetQueuePosition(ObjectGuid guid, uint8 queueIndex, BattlegroundQueue::GroupsQueueType::iterator position);
+
+    // Candidates of the bracket in join order (longest waiting first), their queue iterators are only set by Solo3v3::RevalidateSolo3v3Candidate.
+    // mmrOrder gets the positions of the new candidates of each role in MMR order, copied from the index without sorting.
+    void BuildCandidates(BattlegroundBracketId bracket_id, bool isRated, uint32 now, std::vector<Solo3v3Candidate>& candidates, Solo3v3MMROrder* mmrOrder = nullptr);
+
+private:
+    struct EntrySlot
+    {
+        BattlegroundBracketId bracket_id;
+        uint8 rated;
+        uint32 slot;
+    };
+
+    // Clears the active flag of the entry and compacts its bracket when needed, the slot must be erased by the caller
+    void Deactivate(EntrySlot const& entrySlot);
+
+    // MMR and player of the active entries, per role (MELEE, RANGE, HEALER)
+    typedef std::array<std::set<std::pair<uint32, ObjectGuid>>, HEALER + 1> MMROrder;
+
+    std::array<std::array<Solo3v3QueueEntries, 2>, MAX_BATTLEGROUND_BRACKETS> entries;
+    std::array<std::array<MMROrder, 2>, MAX_BATTLEGROUND_BRACKETS> mmrOrders;
+    std::unordered_map<ObjectGuid, EntrySlot> slots;
+    std::mutex lock;
+};
+
+#define sSolo3v3QueueIndex Solo3v3QueueIndex::instance()
+
+#endif // _SOLO_3V3_QUEUE_INDEX_H_
@@ -0,0 +1,181 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_rank.h"
+#include "solo3v3.h"
+#include "ArenaTeamMgr.h"
+#include <algorithm>
+
+Solo3v3RankIndex* Solo3v3RankIndex::instance()
+{
+    static Solo3v3RankIndex instance;
+    return &instance;
+}
+
+uint32 Solo3v3RankIndex::UpdateRating(uint32 arenaTeamId, uint32 rating)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    BuildIfNeeded();
+
+    rating = std::min(rating, MAX_RATING);
+    MoveTeam(arenaTeamId, rating);
+
+    return teamRatings.size() - CountAtMost(rating) + 1;
+}
+
+void Solo3v3RankIndex::UpdateRatings(std::vector<Solo3v3RatingUpdate>& updates)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    BuildIfNeeded();
+
+    for (Solo3v3RatingUpdate& update : updates)
+    {
+        update.rating = std::min(update.rating, MAX_RATING);
+        MoveTeam(update.arenaTeamId, update.rating);
+    }
+
+    for (Solo3v3RatingUpdate& update : updates)
+        update.rank = teamRatings.size() - CountAtMost(update.rating) + 1;
+}
+
+void Solo3v3RankIndex::AddTeam(uint32 arenaTeamId, uint32 rating)
+{
+    UpdateRating(arenaTeamId, rating);
+}
+
+void Solo3v3RankIndex::RemoveTeam(uint32 arenaTeamId)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    BuildIfNeeded();
+
+    Remove(arenaTeamId);
+}
+
+void Solo3v3RankIndex::CheckTeam(uint32 arenaTeamId)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    checkedTeams.insert(arenaTeamId);
+}
+
+void Solo3v3RankIndex::Update(uint32 diff)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    // not loaded yet, the build only adds existing teams
+    if (!built)
+    {
+        checkedTeams.clear();
+        return;
+    }
+
+    // the core removes the team after the member, so the check waits for the next world update
+    for (uint32 arenaTeamId : checkedTeams)
+        if (IsGone(arenaTeamId))
+            Remove(arenaTeamId);
+
+    checkedTeams.clear();
+
+    pruneTimer += diff;
+    if (pruneTimer < PRUNE_INTERVAL)
+        return;
+
+    pruneTimer = 0;
+
+    std::vector<uint32> goneTeams;
+    for (auto const& [arenaTeamId, rating] : teamRatings)
+        if (IsGone(arenaTeamId))
+            goneTeams.push_back(arenaTeamId);
+
+    for (uint32 arenaTeamId : goneTeams)
+        Remove(arenaTeamId);
+}
+
+bool Solo3v3RankIndex::IsGone(uint32 arenaTeamId) const
+{
+    ArenaTeam* arenaTeam = sArenaTeamMgr->GetArenaTeamById(arenaTeamId);
+    return !arenaTeam || !arenaTeam->GetMembersSize();
+}
+
+void Solo3v3RankIndex::Remove(uint32 arenaTeamId)
+{
+    auto itr = teamRatings.find(arenaTeamId);
+    if (itr == teamRatings.end())
+        return;
+
+    Add(itr->second, -1);
+    teamRatings.erase(itr);
+}
+
+uint32 Solo3v3RankIndex::GetRank(uint32 rating)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    BuildIfNeeded();
+
+    return teamRatings.size() - CountAtMost(std::min(rating, MAX_RATING)) + 1;
+}
+
+void Solo3v3RankIndex::BuildIfNeeded()
+{
+    if (built)
+        return;
+
+    built = true;
+    tree.assign(MAX_RATING + 2, 0);
+
+    for (ArenaTeamMgr::ArenaTeamContainer::const_iterator itr = sArenaTeamMgr->GetArenaTeamMapBegin(); itr != sArenaTeamMgr->GetArenaTeamMapEnd(); ++itr)
+    {
+        uint32 arenaTeamId = itr->first;
+        ArenaTeam* arenaTeam = itr->second;
+
+        // temp solo teams of running matches are not ranked
+        if (arenaTeam->GetType() != ARENA_TEAM_SOLO_3v3 || arenaTeamId >= MAX_ARENA_TEAM_ID)
+            continue;
+
+        uint32 rating = std::min<uint32>(arenaTeam->GetStats().Rating, MAX_RATING);
+        teamRatings[arenaTeamId] = rating;
+        Add(rating, 1);
+    }
+}
+
+void Solo3v3RankIndex::MoveTeam(uint32 arenaTeamId, uint32 rating)
+{
+    auto itr = teamRatings.find(arenaTeamId);
+    if (itr != teamRatings.end())
+    {
+        Add(itr->second, -1);
+        itr->second = rating;
+    }
+    else
+        teamRatings[arenaTeamId] = rating;
+
+    Add(rating, 1);
+}
+
+void Solo3v3RankIndex::Add(uint32 rating, int32 count)
+{
+    for (uint32 i = rating + 1; i < tree.size(); i += i & -i)
+        tree[i] += count;
+}
+
+uint32 Solo3v3RankIndex::CountAtMost(uint32 rating) const
+{
+    int32 count = 0;
+    for (uint32 i = rating + 1; i > 0; i -= i & -i)
+        count += tree[i];
+
+    return count;
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_RANK_H_
+#define _SOLO_3V3_RANK_H_
+
+#include "Common.h"
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+struct Solo3v3RatingUpdate
+{
+    uint32 arenaTeamId;
+    uint32 rating;
+    uint32 rank; // set by UpdateRatings
+};
+
+// Rating ordered index of the solo 3v3 arena teams (Fenwick tree over the rating range),
+// so a team rank is a prefix count instead of a scan over every arena team.
+class Solo3v3RankIndex
+{
+public:
+    static Solo3v3RankIndex* instance();
+
+    // Moves the team to its new rating and returns its rank (1 + number of solo teams with a higher rating)
+    uint32 UpdateRating(uint32 arenaTeamId, uint32 rating);
+
+    // Same as UpdateRating for several teams under one lock, the ranks account for all the new ratings
+    void UpdateRatings(std::vector<Solo3v3RatingUpdate>& updates);
+
+    void AddTeam(uint32 arenaTeamId, uint32 rating);
+    void RemoveTeam(uint32 arenaTeamId);
+    uint32 GetRank(uint32 rating);
+
+    // The team lost its member through a core path (leave, GM disband, character deletion), it is unranked
+    // on the next Update if it was disbanded or has no member left
+    void CheckTeam(uint32 arenaTeamId);
+
+    // World thread. Handles the checked teams, and every PRUNE_INTERVAL drops the teams that disappeared
+    // without a check (e.g. disbanded while the player was offline)
+    void Update(uint32 diff);
+
+private:
+    // Loads every solo team from sArenaTeamMgr on first use, arena teams are loaded before any match can end
+    void BuildIfNeeded();
+
+    void MoveTeam(uint32 arenaTeamId, uint32 rating);
+    void Add(uint32 rating, int32 count);
+    uint32 CountAtMost(uint32 rating) const;
+
+    // lock held
+    bool IsGone(uint32 arenaTeamId) const;
+    void Remove(uint32 arenaTeamId);
+
+    static constexpr uint32 MAX_RATING = 0xFFFF; // ArenaTeamStats::Rating is an uint16
+    static constexpr uint32 PRUNE_INTERVAL = 5 * MINUTE * IN_MILLISECONDS;
+
+    std::vector<int32> tree;
+    std::unordered_map<uint32, uint32> teamRatings;
+    std::unordered_set<uint32> checkedTeams;
+    std::mutex lock;
+    bool built = false;
+    uint32 pruneTimer = 0;
+};
+
+#define sSolo3v3Rank Solo3v3RankIndex::instance()
+
+#endif // _SOLO_3V3_RANK_H_
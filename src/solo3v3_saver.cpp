@@ -0,0 +1,102 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_saver.h"
+#include "ArenaTeamMgr.h"
+#include "solo3v3_config.h"
+
+Solo3v3TeamSaver* Solo3v3TeamSaver::instance()
+{
+    static Solo3v3TeamSaver instance;
+    return &instance;
+}
+
+void Solo3v3TeamSaver::SaveTeam(ArenaTeam* arenaTeam)
+{
+    if (!sSolo3v3Config.SaveInterval)
+    {
+        arenaTeam->SaveToDB(true);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    dirtyTeams.insert(arenaTeam->GetId());
+}
+
+void Solo3v3TeamSaver::SaveTeams(std::vector<ArenaTeam*> const& arenaTeams)
+{
+    if (!sSolo3v3Config.SaveInterval)
+    {
+        for (ArenaTeam* arenaTeam : arenaTeams)
+            arenaTeam->SaveToDB(true);
+
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (ArenaTeam* arenaTeam : arenaTeams)
+        dirtyTeams.insert(arenaTeam->GetId());
+}
+
+void Solo3v3TeamSaver::Update(uint32 diff)
+{
+    Solo3v3Config const& config = sSolo3v3Config;
+    uint32 interval = config.SaveInterval;
+    uint32 batchSize = config.SaveBatchSize;
+
+    flushTimer += diff;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (dirtyTeams.empty())
+        {
+            flushTimer = 0;
+            return;
+        }
+
+        if (flushTimer < interval && (!batchSize || dirtyTeams.size() < batchSize))
+            return;
+    }
+
+    Flush();
+}
+
+void Solo3v3TeamSaver::Flush()
+{
+    std::unordered_set<uint32> teams;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        teams.swap(dirtyTeams);
+        flushTimer = 0;
+    }
+
+    if (teams.empty())
+        return;
+
+    // through the core save path, so its statements and hooks stay the only definition of a team save
+    for (uint32 arenaTeamId : teams)
+    {
+        ArenaTeam* arenaTeam = sArenaTeamMgr->GetArenaTeamById(arenaTeamId);
+        if (!arenaTeam) // disbanded in the meantime
+            continue;
+
+        arenaTeam->SaveToDB(true);
+    }
+}
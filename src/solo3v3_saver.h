@@ -0,0 +1,53 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_SAVER_H_
+#define _SOLO_3V3_SAVER_H_
+
+#include "Common.h"
+#include "ArenaTeam.h"
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+// Write-behind saving of solo 3v3 arena team stats. Teams are marked dirty when their stats change
+// and the dirty teams are flushed from the world thread, each team once however many matches it played.
+// Every team is written by ArenaTeam::SaveToDB, in its own transaction.
+class Solo3v3TeamSaver
+{
+public:
+    static Solo3v3TeamSaver* instance();
+
+    // Saves right away when Solo.3v3.SaveInterval is 0, otherwise marks the team dirty
+    void SaveTeam(ArenaTeam* arenaTeam);
+
+    // Same as SaveTeam for all teams of a finished match
+    void SaveTeams(std::vector<ArenaTeam*> const& arenaTeams);
+
+    // Called from the world update, flushes when the interval elapsed or enough teams are dirty
+    void Update(uint32 diff);
+    void Flush();
+
+private:
+    std::unordered_set<uint32> dirtyTeams;
+    std::mutex lock;
+    uint32 flushTimer = 0;
+};
+
+#define sSolo3v3Saver Solo3v3TeamSaver::instance()
+
+#endif // _SOLO_3V3_SAVER_H_
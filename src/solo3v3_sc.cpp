@@ -16,51 +16,31 @@
  */
 
 #include "solo3v3_sc.h"
-#include <unordered_map>
-
-struct ArenaTeamsRating {
-    uint32 allianceRating;
-    uint32 hordeRating;
-    uint8 playersCount = 0;
-};
-std::unordered_map<uint32, ArenaTeamsRating> bgArenaTeamsRating;
-
-void NpcSolo3v3::Initialize()
-{
-    for (int i = 0; i < MAX_TALENT_CAT; i++)
-        cache3v3Queue[i] = 0;
-
-    lastFetchQueueList = 0;
-}
+#include "solo3v3_config.h"
+#include "solo3v3_matchmaker.h"
+#include "solo3v3_queue_counters.h"
+#include "solo3v3_queue_index.h"
+#include "solo3v3_rank.h"
+#include "solo3v3_saver.h"
+#include "solo3v3_stats.h"
+#include "solo3v3_teams.h"
+#include "solo3v3_trace.h"
+#include "solo3v3_wait_stats.h"
+#include "solo3v3_workers.h"
+#include "GameTime.h"
 
 bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
 {
     if (!player || !creature)
         return true;
 
-    if (sConfigMgr->GetOption<bool>("Solo.3v3.Enable", true) == false)
+    if (!sSolo3v3Config.Enable)
     {
         ChatHandler(player->GetSession()).SendSysMessage("Arena disabled!");
         return true;
     }
 
-    bool MeleeCasterHealer = sConfigMgr->GetOption<bool>("Solo.3v3.MeleeCasterHealer", false);
-
-    fetchQueueList();
-    std::stringstream infoQueue;
-
-    infoQueue << "             Melee Caster Healer: " << (MeleeCasterHealer ? "|cff00ff00On|r" : "|cffff0000Off|r");
-    infoQueue << "\n ---------------------------------------------";
-    infoQueue << "\n               " << (cache3v3Queue[MELEE] + cache3v3Queue[RANGE] + cache3v3Queue[HEALER]) << " Queued Player(s)";
-    infoQueue << "\n                 |TInterface/ICONS/ability_rogue_shadowstrikes:21:21:0:11|t       |TInterface/ICONS/spell_shadow_shadowembrace:21:21:0:11|t        |TInterface/ICONS/spell_holy_holynova:21:21:0:11|t";
-    infoQueue << "\n\n              Melee  Caster  Healer";
-    infoQueue << "\n                 [" << cache3v3Queue[MELEE] << "]        [" << cache3v3Queue[RANGE] << "]        [" << cache3v3Queue[HEALER] << "]";
-    infoQueue << "\n\n   |TInterface\\icons\\inv_jewelry_talisman_04:17:17:0:30|t [" << cache3v3Queue[SHAMAN] << "]  " << " |TInterface\\icons\\inv_hammer_01:17:17:0:30|t [" << cache3v3Queue[PALADIN] << "]  "
-        << " |TInterface\\icons\\inv_sword_27:17:17:0:30|t [" << cache3v3Queue[WARRIOR] << "]  " << " |TInterface\\icons\\inv_misc_monsterclaw_04:17:17:0:30|t [" << cache3v3Queue[DRUID] << "]  "
-        << " |TInterface\\icons\\spell_deathknight_classicon:17:17:0:30|t [" << cache3v3Queue[DK] << "]" << "\n   |TInterface\\icons\\spell_nature_drowsy:17:17:0:30|t [" << cache3v3Queue[WARLOCK] << "]  "
-        << " |TInterface\\icons\\inv_staff_30:17:17:0:30|t [" << cache3v3Queue[PRIEST] << "]  " << " |TInterface\\icons\\inv_weapon_bow_07:17:17:0:30|t [" << cache3v3Queue[HUNTER] << "]  "
-        << " |TInterface\\icons\\inv_staff_13:17:17:0:30|t [" << cache3v3Queue[MAGE] << "]  " << " |TInterface\\icons\\inv_throwingknife_04:17:17:0:30|t [" << cache3v3Queue[ROGUE] << "]";
-    AddGossipItemFor(player, GOSSIP_ICON_CHAT, infoQueue.str().c_str(), GOSSIP_SENDER_MAIN, 0);
+    AddGossipItemFor(player, GOSSIP_ICON_CHAT, GetQueueInfo(sSolo3v3Config.MeleeCasterHealer), GOSSIP_SENDER_MAIN, 0);
 
     if (player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO))
         AddGossipItemFor(player, GOSSIP_ICON_BATTLE, "|TInterface/ICONS/Achievement_Arena_2v2_7:30:30:-18:0|t Leave Solo queue", GOSSIP_SENDER_MAIN, NPC_3v3_ACTION_LEAVE_QUEUE, "Are you sure you want to remove the solo queue?", 0, false);
@@ -70,7 +50,7 @@ bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
 
     if (!player->GetArenaTeamId(ARENA_SLOT_SOLO_3v3))
     {
-        uint32 cost = sConfigMgr->GetOption<uint32>("Solo.3v3.Cost", 1);
+        uint32 cost = sSolo3v3Config.Cost;
         if (player->IsPvP())
             cost = 0;
 
@@ -94,6 +74,44 @@ bool NpcSolo3v3::OnGossipHello(Player* player, Creature* creature)
     return true;
 }
 
+std::string NpcSolo3v3::GetQueueInfo(bool MeleeCasterHealer)
+{
+    Solo3v3HookTimer timer(SOLO_3V3_HOOK_QUEUE_INFO);
+
+    // read the version before the counts, a change in between only causes one more rebuild
+    uint32 version = sSolo3v3QueueCounters->GetVersion();
+
+    std::lock_guard<std::mutex> guard(queueInfoLock);
+
+    if (!queueInfo.empty() && queueInfoVersion == version && queueInfoMeleeCasterHealer == MeleeCasterHealer)
+        return queueInfo;
+
+    queueInfo = RenderQueueInfo(MeleeCasterHealer, sSolo3v3QueueCounters->GetCounts());
+    queueInfoVersion = version;
+    queueInfoMeleeCasterHealer = MeleeCasterHealer;
+
+    return queueInfo;
+}
+
+std::string NpcSolo3v3::RenderQueueInfo(bool MeleeCasterHealer, Solo3v3QueueCounts const& cache3v3Queue)
+{
+    std::stringstream infoQueue;
+
+    infoQueue << "             Melee Caster Healer: " << (MeleeCasterHealer ? "|cff00ff00On|r" : "|cffff0000Off|r");
+    infoQueue << "\n ---------------------------------------------";
+    infoQueue << "\n               " << (cache3v3Queue[MELEE] + cache3v3Queue[RANGE] + cache3v3Queue[HEALER]) << " Queued Player(s)";
+    infoQueue << "\n                 |TInterface/ICONS/ability_rogue_shadowstrikes:21:21:0:11|t       |TInterface/ICONS/spell_shadow_shadowembrace:21:21:0:11|t        |TInterface/ICONS/spell_holy_holynova:21:21:0:11|t";
+    infoQueue << "\n\n              Melee  Caster  Healer";
+    infoQueue << "\n                 [" << cache3v3Queue[MELEE] << "]        [" << cache3v3Queue[RANGE] << "]        [" << cache3v3Queue[HEALER] << "]";
+    infoQueue << "\n\n   |TInterface\\icons\\inv_jewelry_talisman_04:17:17:0:30|t [" << cache3v3Queue[SHAMAN] << "]  " << " |TInterface\\icons\\inv_hammer_01:17:17:0:30|t [" << cache3v3Queue[PALADIN] << "]  "
+        << " |TInterface\\icons\\inv_sword_27:17:17:0:30|t [" << cache3v3Queue[WARRIOR] << "]  " << " |TInterface\\icons\\inv_misc_monsterclaw_04:17:17:0:30|t [" << cache3v3Queue[DRUID] << "]  "
+        << " |TInterface\\icons\\spell_deathknight_classicon:17:17:0:30|t [" << cache3v3Queue[DK] << "]" << "\n   |TInterface\\icons\\spell_nature_drowsy:17:17:0:30|t [" << cache3v3Queue[WARLOCK] << "]  "
+        << " |TInterface\\icons\\inv_staff_30:17:17:0:30|t [" << cache3v3Queue[PRIEST] << "]  " << " |TInterface\\icons\\inv_weapon_bow_07:17:17:0:30|t [" << cache3v3Queue[HUNTER] << "]  "
+        << " |TInterface\\icons\\inv_staff_13:17:17:0:30|t [" << cache3v3Queue[MAGE] << "]  " << " |TInterface\\icons\\inv_throwingknife_04:17:17:0:30|t [" << cache3v3Queue[ROGUE] << "]";
+
+    return infoQueue.str();
+}
+
 bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sender*/, uint32 action)
 {
     if (!player || !creature)
@@ -105,19 +123,19 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
     {
         case NPC_3v3_ACTION_CREATE_ARENA_TEAM:
         {
-            if (sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 80) <= player->GetLevel())
+            if (sSolo3v3Config.MinLevel <= player->GetLevel())
             {
-                int cost = sConfigMgr->GetOption<uint32>("Solo.3v3.Cost", 1);
+                int cost = sSolo3v3Config.Cost;
 
                 if (player->IsPvP())
                     cost = 0;
 
                 if (cost >= 0 && player->GetMoney() >= uint32(cost) && CreateArenateam(player, creature))
-                    player->ModifyMoney(sConfigMgr->GetOption<uint32>("Solo.3v3.Cost", 1) * -1);
+                    player->ModifyMoney(sSolo3v3Config.Cost * -1);
             }
             else
             {
-                ChatHandler(player->GetSession()).PSendSysMessage("You need level {}+ to create an arena team.", sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 80));
+                ChatHandler(player->GetSession()).PSendSysMessage("You need level {}+ to create an arena team.", sSolo3v3Config.MinLevel);
             }
 
             CloseGossipMenuFor(player);
@@ -128,7 +146,7 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
         case NPC_3v3_ACTION_JOIN_QUEUE_ARENA_RATED:
         {
             // check Deserter debuff
-            if (player->HasAura(26013) && (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true) || sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true)))
+            if (player->HasAura(26013) && sSolo3v3Config.CastDeserter())
             {
                 WorldPacket data;
                 sBattlegroundMgr->BuildGroupJoinedBattlegroundPacket(&data, ERR_GROUP_JOIN_BATTLEGROUND_DESERTERS);
@@ -146,7 +164,7 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
         case NPC_3v3_ACTION_JOIN_QUEUE_ARENA_UNRATED:
         {
             // check Deserter debuff
-            if (player->HasAura(26013) && (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true) || sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true)))
+            if (player->HasAura(26013) && sSolo3v3Config.CastDeserter())
             {
                 WorldPacket data;
                 sBattlegroundMgr->BuildGroupJoinedBattlegroundPacket(&data, ERR_GROUP_JOIN_BATTLEGROUND_DESERTERS);
@@ -171,6 +189,13 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
                 player->GetSession()->HandleBattleFieldPortOpcode(Data);
                 CloseGossipMenuFor(player);
 
+                if (!player->InBattlegroundQueueForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO))
+                {
+                    sSolo3v3QueueCounters->RemovePlayer(player->GetGUID());
+                    if (sSolo3v3QueueIndex->RemovePlayer(player->GetGUID()))
+                        sSolo3v3Trace->RecordPlayer(SOLO_3V3_TRACE_LEAVE, player->GetGUID());
+                }
+
             }
             return true;
         }
@@ -210,10 +235,19 @@ bool NpcSolo3v3::OnGossipSelect(Player* player, Creature* creature, uint32 /*sen
         }
         case NPC_3v3_ACTION_DISBAND_ARENATEAM:
         {
+            uint32 arenaTeamId = player->GetArenaTeamId(ARENA_SLOT_SOLO_3v3);
+
             WorldPacket Data;
-            Data << player->GetArenaTeamId(ARENA_SLOT_SOLO_3v3);
+            Data << arenaTeamId;
             player->GetSession()->HandleArenaTeamLeaveOpcode(Data);
-            ChatHandler(player->GetSession()).PSendSysMessage("Arena team deleted!");
+
+            // the core can refuse the leave, only unrank the team once it is really gone
+            if (!sArenaTeamMgr->GetArenaTeamById(arenaTeamId))
+            {
+                sSolo3v3Rank->RemoveTeam(arenaTeamId);
+                ChatHandler(player->GetSession()).PSendSysMessage("Arena team deleted!");
+            }
+
             CloseGossipMenuFor(player);
             return true;
         }
@@ -245,7 +279,7 @@ bool NpcSolo3v3::ArenaCheckFullEquipAndTalents(Player* player)
     if (!player)
         return false;
 
-    if (!sConfigMgr->GetOption<bool>("Arena.CheckEquipAndTalents", true))
+    if (!sSolo3v3Config.CheckEquipAndTalents)
         return true;
 
     std::stringstream err;
@@ -281,7 +315,7 @@ bool NpcSolo3v3::JoinQueueArena(Player* player, Creature* /*creature*/, bool isR
     if (!player)
         return false;
 
-    if (sConfigMgr->GetOption<uint32>("Solo.3v3.MinLevel", 80) > player->GetLevel())
+    if (sSolo3v3Config.MinLevel > player->GetLevel())
         return false;
 
     uint8 arenatype = ARENA_TYPE_3v3_SOLO;
@@ -336,9 +370,11 @@ bool NpcSolo3v3::JoinQueueArena(Player* player, Creature* /*creature*/, bool isR
             return false;
         }
 
-        // get the team rating for queueing
+        // get the team rating and the player's matchmaker rating for queueing
         arenaRating = std::max(0u, at->GetRating());
         matchmakerRating = arenaRating;
+        if (ArenaTeamMember const* member = at->GetMember(player->GetGUID()))
+            matchmakerRating = member->MatchMakerRating;
         // the arenateam id must match for everyone in the group
     }
 
@@ -349,7 +385,17 @@ bool NpcSolo3v3::JoinQueueArena(Player* player, Creature* /*creature*/, bool isR
     bg->SetMinPlayersPerTeam(3);
 
     GroupQueueInfo* ginfo = bgQueue.AddGroup(player, nullptr, bgTypeId, bracketEntry, arenatype, isRated, false, arenaRating, matchmakerRating, ateamId, 0);
-    uint32 avgTime = bgQueue.GetAverageQueueWaitTime(ginfo);
+
+    // classify the player once on join, the matchmaker and the queue counters only read the cached category
+    Solo3v3TalentCat talentCat = sSolo->GetCachedTalentCat(player);
+    sSolo3v3QueueCounters->AddPlayer(player, talentCat);
+    sSolo3v3QueueIndex->AddPlayer(&bgQueue, player, ginfo, bracketEntry->GetBracketId(), isRated, talentCat);
+    sSolo3v3Trace->RecordJoin(player->GetGUID(), bracketEntry->GetBracketId(), isRated, talentCat, player->getClass(), ginfo->teamId, matchmakerRating);
+
+    // the core average mixes every role, use the recent wait of the player's role when there is enough of it
+    uint32 avgTime = sSolo3v3WaitStats->GetEstimate(bracketEntry->GetBracketId(), isRated, talentCat);
+    if (!avgTime)
+        avgTime = bgQueue.GetAverageQueueWaitTime(ginfo);
     uint32 queueSlot = player->AddBattlegroundQueueId(bgQueueTypeId);
 
     // send status packet (in queue)
@@ -409,135 +455,129 @@ bool NpcSolo3v3::CreateArenateam(Player* player, Creature* /*creature*/)
 
     // Register arena team
     sArenaTeamMgr->AddArenaTeam(arenaTeam);
+    sSolo3v3Rank->AddTeam(arenaTeam->GetId(), arenaTeam->GetStats().Rating);
+    sSolo3v3Teams->SetTeamId(player->GetGUID(), arenaTeam->GetId());
 
     ChatHandler(player->GetSession()).SendSysMessage("Arena team successful created!");
 
     return true;
 }
 
-void NpcSolo3v3::fetchQueueList()
+void Solo3v3BG::OnQueueUpdate(BattlegroundQueue* queue, uint32 /*diff*/, BattlegroundTypeId bgTypeId, BattlegroundBracketId bracket_id, uint8 arenaType, bool isRated, uint32 /*arenaRatedTeamId*/)
 {
-    if (GetMSTimeDiffToNow(lastFetchQueueList) < 1000)
+    if (arenaType != (ArenaType)ARENA_TYPE_3v3_SOLO)
         return;
 
-    lastFetchQueueList = getMSTime();
+    Solo3v3HookTimer timer(SOLO_3V3_HOOK_QUEUE_UPDATE);
+
+    Battleground* bg_template = sBattlegroundMgr->GetBattlegroundTemplate(bgTypeId);
+
+    if (!bg_template)
+        return;
 
-    BattlegroundQueue* queue = &sBattlegroundMgr->GetBattlegroundQueue((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO);
+    PvPDifficultyEntry const* bracketEntry = GetBattlegroundBracketById(bg_template->GetMapId(), bracket_id);
+    if (!bracketEntry)
+        return;
 
-    for (int i = 0; i < MAX_TALENT_CAT; i++)
-        cache3v3Queue[i] = 0;
+    // keep forming matches from the remaining (not yet invited) players until no valid composition is left
+    uint32 maxArenas = sSolo3v3Config.MaxArenasPerQueueUpdate;
 
-    for (int i = BG_BRACKET_ID_FIRST; i <= BG_BRACKET_ID_LAST; i++)
+    // select on a worker, the arenas are created on a later world tick
+    if (sSolo3v3Workers->IsEnabled())
     {
-        for (int j = 0; j < 2; j++)
-        {
-            for (auto queueInfo : queue->m_QueuedGroups[i][j])
-            {
-                if (queueInfo->IsInvitedToBGInstanceGUID) // Skip when invited
-                    continue;
+        std::unique_ptr<Solo3v3MatchJob> job = std::make_unique<Solo3v3MatchJob>();
+        job->queue = queue;
+        job->bgTypeId = bgTypeId;
+        job->bracketEntry = bracketEntry;
+        job->bracket_id = bracket_id;
+        job->arenaType = arenaType;
+        job->isRated = isRated;
+        job->maxArenas = maxArenas;
+        job->settings = sSolo->GetMatchSettings();
 
-                for (auto const& playerGuid : queueInfo->Players)
-                {
-                    Player* _player = ObjectAccessor::FindPlayer(playerGuid);
-                    if (!_player)
-                        continue;
+        sSolo->BuildSolo3v3Candidates(queue, bracket_id, isRated, job->candidates, job->settings.UsesMMRWindow(isRated) ? &job->mmrOrder : nullptr);
 
-                    switch (_player->getClass())
-                    {
-                        case CLASS_WARRIOR:
-                            cache3v3Queue[WARRIOR]++;
-                            break;
-                        case CLASS_PALADIN:
-                            cache3v3Queue[PALADIN]++;
-                            break;
-                        case CLASS_DEATH_KNIGHT:
-                            cache3v3Queue[DK]++;
-                            break;
-                        case CLASS_HUNTER:
-                            cache3v3Queue[HUNTER]++;
-                            break;
-                        case CLASS_SHAMAN:
-                            cache3v3Queue[SHAMAN]++;
-                            break;
-                        case CLASS_ROGUE:
-                            cache3v3Queue[ROGUE]++;
-                            break;
-                        case CLASS_DRUID:
-                            cache3v3Queue[DRUID]++;
-                            break;
-                        case CLASS_MAGE:
-                            cache3v3Queue[MAGE]++;
-                            break;
-                        case CLASS_WARLOCK:
-                            cache3v3Queue[WARLOCK]++;
-                            break;
-                        case CLASS_PRIEST:
-                            cache3v3Queue[PRIEST]++;
-                            break;
-                        default:
-                            break;
-                    }
+        if (job->candidates.size() >= job->settings.MinPlayersPerTeam * BG_TEAMS_COUNT)
+            sSolo3v3Workers->Submit(std::move(job));
 
-                    Solo3v3TalentCat plrCat = sSolo->GetTalentCatForSolo3v3(_player); // get talent cat
-                    cache3v3Queue[plrCat]++;
-                }
-            }
+        return;
+    }
+
+    uint32 arenasCreated = 0;
+    bool finished = false;
+
+    sSolo3v3Matchmaker->Begin(bracket_id, isRated);
+
+    while (!maxArenas || arenasCreated < maxArenas)
+    {
+        bool deferred = false;
+        if (!sSolo->CheckSolo3v3Arena(queue, bracket_id, isRated, deferred) || !CreateSolo3v3Arena(queue, bgTypeId, bracketEntry, arenaType, isRated))
+        {
+            finished = !deferred;
+            break;
         }
+
+        ++arenasCreated;
+
+        if (sSolo3v3Matchmaker->BudgetExceeded())
+            break;
     }
-}
 
-void Solo3v3BG::OnQueueUpdate(BattlegroundQueue* queue, uint32 /*diff*/, BattlegroundTypeId bgTypeId, BattlegroundBracketId bracket_id, uint8 arenaType, bool isRated, uint32 /*arenaRatedTeamId*/)
-{
-    if (arenaType != (ArenaType)ARENA_TYPE_3v3_SOLO)
-        return;
+    // out of budget, the remaining players are matched on the next tick
+    bool resume = !finished && (!maxArenas || arenasCreated < maxArenas);
+    if (resume)
+        sBattlegroundMgr->ScheduleQueueUpdate(isRated ? 1 : 0, ARENA_TYPE_3v3_SOLO, bgQueueTypeId, bgTypeId, bracket_id);
 
-    Battleground* bg_template = sBattlegroundMgr->GetBattlegroundTemplate(bgTypeId);
+    sSolo3v3Matchmaker->End(arenasCreated, !resume);
+}
 
-    if (!bg_template)
-        return;
+bool Solo3v3BG::CreateSolo3v3Arena(BattlegroundQueue* queue, BattlegroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry, uint8 arenaType, bool isRated)
+{
+    Battleground* arena = sBattlegroundMgr->CreateNewBattleground(bgTypeId, bracketEntry, arenaType, isRated);
+    if (!arena)
+        return false;
 
-    PvPDifficultyEntry const* bracketEntry = GetBattlegroundBracketById(bg_template->GetMapId(), bracket_id);
-    if (!bracketEntry)
-        return;
+    // Create temp arena team and store arenaTeamId
+    ArenaTeam* arenaTeams[BG_TEAMS_COUNT];
+    sSolo->CreateTempArenaTeamForQueue(queue, arenaTeams);
 
-    if (sSolo->CheckSolo3v3Arena(queue, bracket_id, isRated))
-    {
-        Battleground* arena = sBattlegroundMgr->CreateNewBattleground(bgTypeId, bracketEntry, arenaType, isRated);
-        if (!arena)
-            return;
+    // invite those selection pools
+    for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
+        for (auto const& citr : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
+        {
+            citr->ArenaTeamId = arenaTeams[i]->GetId();
+            queue->InviteGroupToBG(citr, arena, citr->teamId);
 
-        // Create temp arena team and store arenaTeamId
-        ArenaTeam* arenaTeams[BG_TEAMS_COUNT];
-        sSolo->CreateTempArenaTeamForQueue(queue, arenaTeams);
+            uint32 waitTime = uint32(GameTime::GetGameTimeMS().count()) - citr->JoinTime;
 
-        // invite those selection pools
-        for (uint32 i = 0; i < BG_TEAMS_COUNT; i++)
-            for (auto const& citr : queue->m_SelectionPools[TEAM_ALLIANCE + i].SelectedGroups)
+            for (auto const& playerGuid : citr->Players)
             {
-                citr->ArenaTeamId = arenaTeams[i]->GetId();
-                queue->InviteGroupToBG(citr, arena, citr->teamId);
+                sSolo3v3WaitStats->AddWait(bracketEntry->GetBracketId(), isRated, sSolo3v3QueueIndex->GetRole(playerGuid), waitTime);
+                sSolo3v3QueueCounters->RemovePlayer(playerGuid);
+                sSolo3v3QueueIndex->RemovePlayer(playerGuid);
+                sSolo3v3Trace->RecordPlayer(SOLO_3V3_TRACE_INVITE, playerGuid, arena->GetInstanceID(), i);
             }
+        }
 
-        // Override ArenaTeamId to temp arena team (was first set in InviteGroupToBG)
-        arena->SetArenaTeamIdForTeam(TEAM_ALLIANCE, arenaTeams[TEAM_ALLIANCE]->GetId());
-        arena->SetArenaTeamIdForTeam(TEAM_HORDE, arenaTeams[TEAM_HORDE]->GetId());
+    // Override ArenaTeamId to temp arena team (was first set in InviteGroupToBG)
+    arena->SetArenaTeamIdForTeam(TEAM_ALLIANCE, arenaTeams[TEAM_ALLIANCE]->GetId());
+    arena->SetArenaTeamIdForTeam(TEAM_HORDE, arenaTeams[TEAM_HORDE]->GetId());
 
-        if (isRated) {
-            ArenaTeamsRating arenaTeamsRating;
+    if (isRated)
+        sSolo3v3Matches->Add(arena->GetInstanceID(), arenaTeams[TEAM_ALLIANCE]->GetStats().Rating, arenaTeams[TEAM_HORDE]->GetStats().Rating);
 
-            arenaTeamsRating.allianceRating = arenaTeams[TEAM_ALLIANCE]->GetStats().Rating;
-            arenaTeamsRating.hordeRating = arenaTeams[TEAM_HORDE]->GetStats().Rating;
+    // Set matchmaker rating for calculating rating-modifier on EndBattleground (when a team has won/lost)
+    arena->SetArenaMatchmakerRating(TEAM_ALLIANCE, sSolo->GetAverageMMR(arenaTeams[TEAM_ALLIANCE], queue->m_SelectionPools[TEAM_ALLIANCE].SelectedGroups));
+    arena->SetArenaMatchmakerRating(TEAM_HORDE, sSolo->GetAverageMMR(arenaTeams[TEAM_HORDE], queue->m_SelectionPools[TEAM_HORDE].SelectedGroups));
 
-            bgArenaTeamsRating[arena->GetInstanceID()] = arenaTeamsRating;
-        }
+    uint32 allianceMMR = arena->GetArenaMatchmakerRating(TEAM_ALLIANCE);
+    uint32 hordeMMR = arena->GetArenaMatchmakerRating(TEAM_HORDE);
+    sSolo3v3Trace->RecordMatch(arena->GetInstanceID(), bracketEntry->GetBracketId(), isRated, allianceMMR > hordeMMR ? allianceMMR - hordeMMR : hordeMMR - allianceMMR);
 
-        // Set matchmaker rating for calculating rating-modifier on EndBattleground (when a team has won/lost)
-        arena->SetArenaMatchmakerRating(TEAM_ALLIANCE, sSolo->GetAverageMMR(arenaTeams[TEAM_ALLIANCE]));
-        arena->SetArenaMatchmakerRating(TEAM_HORDE, sSolo->GetAverageMMR(arenaTeams[TEAM_HORDE]));
+    // start bg
+    arena->StartBattleground();
 
-        // start bg
-        arena->StartBattleground();
-    }
+    return true;
 }
 
 bool Solo3v3BG::OnQueueUpdateValidity(BattlegroundQueue* /* queue */, uint32 /*diff*/, BattlegroundTypeId /* bgTypeId */, BattlegroundBracketId /* bracket_id */, uint8 arenaType, bool /* isRated */, uint32 /*arenaRatedTeamId*/)
@@ -551,6 +591,7 @@ bool Solo3v3BG::OnQueueUpdateValidity(BattlegroundQueue* /* queue */, uint32 /*d
 
 void Solo3v3BG::OnBattlegroundDestroy(Battleground* bg)
 {
+    sSolo3v3Matches->Remove(bg->GetInstanceID());
     sSolo->CleanUp3v3SoloQ(bg);
 }
 
@@ -558,34 +599,82 @@ void Solo3v3BG::OnBattlegroundEndReward(Battleground* bg, Player* player, TeamId
 {
     if (bg->isRated() && bg->GetArenaType() == ARENA_TYPE_3v3_SOLO)
     {
-        // this way we always get the correct solo team (sometimes when using GetArenaTeamByCaptain inside solo arena it can return a teamID >= 4293918720)
-        ArenaTeam* plrArenaTeam = sArenaTeamMgr->GetArenaTeamById(player->GetArenaTeamId(ARENA_SLOT_SOLO_3v3));
+        Solo3v3HookTimer timer(SOLO_3V3_HOOK_END_REWARD);
 
-        if (!plrArenaTeam)
+        // the hook runs for every player, the first call settles the whole match and removes its context
+        Solo3v3MatchContext matchContext;
+        if (!sSolo3v3Matches->Take(bg->GetInstanceID(), matchContext))
             return;
 
-        ArenaTeamStats atStats = plrArenaTeam->GetStats();
-        int32 ratingModifier;
+        SettleSolo3v3Match(bg, winnerTeamId, matchContext);
+        sSolo3v3Trace->RecordResult(bg->GetInstanceID(), winnerTeamId);
+
+        // kick player -- saving alt tab time for testing
+        Battleground::BattlegroundPlayerMap const& pl = bg->GetPlayers();
+        for (Battleground::BattlegroundPlayerMap::const_iterator itr = pl.begin(); itr != pl.end(); ++itr)
+        {
+            if (!player || player->IsSpectator())
+                continue;
+
+            if (Player* plr = ObjectAccessor::FindPlayer(itr->first))
+                plr->LeaveBattleground();
+        }
+    }
+}
+
+void Solo3v3BG::SettleSolo3v3Match(Battleground* bg, TeamId winnerTeamId, Solo3v3MatchContext const& matchContext)
+{
+    // rating change of each side, from the temp team rating before and after the match
+    int32 ratingModifiers[BG_TEAMS_COUNT];
+    for (uint8 i = 0; i < BG_TEAMS_COUNT; ++i)
+    {
+        TeamId bgTeamId = TeamId(TEAM_ALLIANCE + i);
+        ArenaTeam* tempArenaTeam;
         int32 oldTeamRating;
 
-        uint32 oldTeamRatingAlliance = bgArenaTeamsRating[bg->GetInstanceID()].allianceRating;
-        uint32 oldTeamRatingHorde = bgArenaTeamsRating[bg->GetInstanceID()].hordeRating;
+        if (bgTeamId == winnerTeamId)
+        {
+            tempArenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(winnerTeamId));
+            oldTeamRating = winnerTeamId == TEAM_HORDE ? matchContext.hordeRating : matchContext.allianceRating;
+        }
+        else
+        {
+            tempArenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(winnerTeamId == TEAM_NEUTRAL ? TEAM_ALLIANCE : bg->GetOtherTeamId(winnerTeamId)));
+            oldTeamRating = winnerTeamId != TEAM_HORDE ? matchContext.hordeRating : matchContext.allianceRating;
+        }
+
+        ratingModifiers[i] = tempArenaTeam ? int32(tempArenaTeam->GetRating()) - oldTeamRating : 0;
+    }
+
+    struct SettledTeam
+    {
+        ArenaTeam* arenaTeam;
+        ArenaTeamStats stats;
+    };
+
+    std::vector<SettledTeam> settledTeams;
+    std::vector<Solo3v3RatingUpdate> ratingUpdates;
+
+    for (auto const& [playerGuid, player] : bg->GetPlayers())
+    {
+        if (!player || player->IsSpectator())
+            continue;
+
+        // this way we always get the correct solo team (sometimes when using GetArenaTeamByCaptain inside solo arena it can return a teamID >= 4293918720)
+        ArenaTeam* plrArenaTeam = sArenaTeamMgr->GetArenaTeamById(player->GetArenaTeamId(ARENA_SLOT_SOLO_3v3));
 
-        bgArenaTeamsRating[bg->GetInstanceID()].playersCount += 1;
+        if (!plrArenaTeam)
+            continue;
+
+        ArenaTeamStats atStats = plrArenaTeam->GetStats();
 
         TeamId bgTeamId = player->GetBgTeamId();
         const bool isPlayerWinning = bgTeamId == winnerTeamId;
-        if (isPlayerWinning) {
-            ArenaTeam* winnerArenaTeam = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(winnerTeamId == TEAM_NEUTRAL ? TEAM_HORDE : winnerTeamId));
-            oldTeamRating = winnerTeamId == TEAM_HORDE ? oldTeamRatingHorde : oldTeamRatingAlliance;
-            ratingModifier = int32(winnerArenaTeam->GetRating()) - oldTeamRating;
+        int32 ratingModifier = ratingModifiers[bgTeamId == TEAM_HORDE ? TEAM_HORDE : TEAM_ALLIANCE];
 
+        if (isPlayerWinning) {
             atStats.SeasonWins += 1;
             atStats.WeekWins += 1;
-        } else {
-            ArenaTeam* loserArenaTeam  = sArenaTeamMgr->GetArenaTeamById(bg->GetArenaTeamIdForTeam(winnerTeamId == TEAM_NEUTRAL ? TEAM_ALLIANCE : bg->GetOtherTeamId(winnerTeamId)));
-            oldTeamRating = winnerTeamId != TEAM_HORDE ? oldTeamRatingHorde : oldTeamRatingAlliance;
-            ratingModifier = int32(loserArenaTeam->GetRating()) - oldTeamRating;
         }
 
         if (int32(atStats.Rating) + ratingModifier < 0)
@@ -596,14 +685,6 @@ void Solo3v3BG::OnBattlegroundEndReward(Battleground* bg, Player* player, TeamId
         atStats.SeasonGames += 1;
         atStats.WeekGames += 1;
 
-        // Update team's rank, start with rank 1 and increase until no team with more rating was found
-        atStats.Rank = 1;
-        ArenaTeamMgr::ArenaTeamContainer::const_iterator i = sArenaTeamMgr->GetArenaTeamMapBegin();
-        for (; i != sArenaTeamMgr->GetArenaTeamMapEnd(); ++i) {
-            if (i->second->GetType() == ARENA_TEAM_SOLO_3v3 && i->second->GetStats().Rating > atStats.Rating)
-                ++atStats.Rank;
-        }
-
         for (ArenaTeam::MemberList::iterator itr = plrArenaTeam->GetMembers().begin(); itr != plrArenaTeam->GetMembers().end(); ++itr)
         {
             if (itr->Guid == player->GetGUID())
@@ -629,28 +710,30 @@ void Solo3v3BG::OnBattlegroundEndReward(Battleground* bg, Player* player, TeamId
 
                 break;
             }
-
         }
 
-        plrArenaTeam->SetArenaTeamStats(atStats);
-        plrArenaTeam->NotifyStatsChanged();
-        plrArenaTeam->SaveToDB(true);
+        settledTeams.push_back({ plrArenaTeam, atStats });
+        ratingUpdates.push_back({ plrArenaTeam->GetId(), atStats.Rating, 0 });
+    }
+
+    if (settledTeams.empty())
+        return;
 
-        // if all the players rating have been processed, delete the stored bg rating informations
-        if (bgArenaTeamsRating[bg->GetInstanceID()].playersCount == bg->GetPlayersSize())
-            bgArenaTeamsRating.erase(bg->GetInstanceID());
+    // Update teams' rank, all new ratings of the match at once
+    sSolo3v3Rank->UpdateRatings(ratingUpdates);
 
-        // kick player -- saving alt tab time for testing
-        Battleground::BattlegroundPlayerMap const& pl = bg->GetPlayers();
-        for (Battleground::BattlegroundPlayerMap::const_iterator itr = pl.begin(); itr != pl.end(); ++itr)
-        {
-            if (!player || player->IsSpectator())
-                continue;
+    std::vector<ArenaTeam*> arenaTeams;
+    arenaTeams.reserve(settledTeams.size());
 
-            if (Player* plr = ObjectAccessor::FindPlayer(itr->first))
-                plr->LeaveBattleground();
-        }
+    for (size_t i = 0; i < settledTeams.size(); ++i)
+    {
+        settledTeams[i].stats.Rank = ratingUpdates[i].rank;
+        settledTeams[i].arenaTeam->SetArenaTeamStats(settledTeams[i].stats);
+        settledTeams[i].arenaTeam->NotifyStatsChanged();
+        arenaTeams.push_back(settledTeams[i].arenaTeam);
     }
+
+    sSolo3v3Saver->SaveTeams(arenaTeams);
 }
 
 void ConfigLoader3v3Arena::OnAfterConfigLoad(bool /*Reload*/)
@@ -668,6 +751,119 @@ void ConfigLoader3v3Arena::OnAfterConfigLoad(bool /*Reload*/)
     BattlegroundMgr::queueToBg.insert({ BATTLEGROUND_QUEUE_3v3_SOLO, BATTLEGROUND_AA });
     BattlegroundMgr::QueueToArenaType.emplace(BATTLEGROUND_QUEUE_3v3_SOLO, (ArenaType)ARENA_TYPE_3v3_SOLO);
     BattlegroundMgr::ArenaTypeToQueue.emplace(ARENA_TYPE_3v3_SOLO, (BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO);
+
+    Solo3v3ConfigMgr::instance()->Load();
+}
+
+void Solo3v3QueueScheduler::OnUpdate(uint32 diff)
+{
+    CommitWorkerMatches();
+    sSolo3v3Matchmaker->Update(diff);
+    sSolo3v3Trace->Flush();
+
+    uint32 interval = sSolo3v3Config.QueueUpdateInterval;
+    if (!interval)
+        return;
+
+    updateTimer += diff;
+    if (updateTimer < interval)
+        return;
+
+    updateTimer = 0;
+
+    BattlegroundQueue& queue = sBattlegroundMgr->GetBattlegroundQueue(bgQueueTypeId);
+
+    for (uint32 bracket = BG_BRACKET_ID_FIRST; bracket < MAX_BATTLEGROUND_BRACKETS; ++bracket)
+    {
+        // rated updates are scheduled with a matchmaker rating > 0, unrated ones with 0
+        if (!queue.m_QueuedGroups[bracket][BG_QUEUE_PREMADE_ALLIANCE].empty() || !queue.m_QueuedGroups[bracket][BG_QUEUE_PREMADE_HORDE].empty())
+            sBattlegroundMgr->ScheduleQueueUpdate(1, ARENA_TYPE_3v3_SOLO, bgQueueTypeId, BATTLEGROUND_AA, BattlegroundBracketId(bracket));
+
+        if (!queue.m_QueuedGroups[bracket][BG_QUEUE_NORMAL_ALLIANCE].empty() || !queue.m_QueuedGroups[bracket][BG_QUEUE_NORMAL_HORDE].empty())
+            sBattlegroundMgr->ScheduleQueueUpdate(0, ARENA_TYPE_3v3_SOLO, bgQueueTypeId, BATTLEGROUND_AA, BattlegroundBracketId(bracket));
+    }
+}
+
+void Solo3v3QueueScheduler::OnShutdown()
+{
+    sSolo3v3Workers->Stop();
+    sSolo3v3Trace->Flush();
+}
+
+void Solo3v3QueueScheduler::CommitWorkerMatches()
+{
+    std::vector<std::unique_ptr<Solo3v3MatchJob>> jobs;
+    sSolo3v3Workers->TakeFinished(jobs);
+
+    for (std::unique_ptr<Solo3v3MatchJob> const& job : jobs)
+    {
+        BattlegroundQueue* queue = job->queue;
+        bool updateAgain = false;
+        uint32 arenasCreated = 0;
+
+        sSolo3v3Matchmaker->Begin(job->bracket_id, job->isRated);
+
+        for (Solo3v3MatchResult& match : job->matches)
+        {
+            // out of budget, the next selection starts from the players that are left
+            if (arenasCreated && sSolo3v3Matchmaker->BudgetExceeded())
+            {
+                updateAgain = true;
+                break;
+            }
+
+            // players may have left or been invited since the snapshot, stale index entries are dropped
+            bool valid = true;
+            for (uint8 teamId = TEAM_ALLIANCE; teamId < BG_TEAMS_COUNT; ++teamId)
+                for (Solo3v3Candidate& candidate : match[teamId])
+                    if (!sSolo->RevalidateSolo3v3Candidate(queue, job->bracket_id, candidate))
+                    {
+                        sSolo3v3QueueCounters->RemovePlayer(candidate.playerGuid);
+                        if (sSolo3v3QueueIndex->RemovePlayer(candidate.playerGuid))
+                            sSolo3v3Trace->RecordPlayer(SOLO_3V3_TRACE_LEAVE, candidate.playerGuid);
+                        valid = false;
+                    }
+
+            if (!valid)
+            {
+                updateAgain = true;
+                continue;
+            }
+
+            Solo3v3MatchSelection selected;
+            for (uint8 teamId = TEAM_ALLIANCE; teamId < BG_TEAMS_COUNT; ++teamId)
+                for (Solo3v3Candidate const& candidate : match[teamId])
+                    selected[teamId].push_back(&candidate);
+
+            queue->m_SelectionPools[TEAM_ALLIANCE].Init();
+            queue->m_SelectionPools[TEAM_HORDE].Init();
+            sSolo->CommitSolo3v3Match(queue, job->bracket_id, job->isRated, selected);
+
+            if (!Solo3v3BG::CreateSolo3v3Arena(queue, job->bgTypeId, job->bracketEntry, job->arenaType, job->isRated))
+            {
+                updateAgain = true;
+                break;
+            }
+
+            ++arenasCreated;
+        }
+
+        sSolo3v3Matchmaker->End(arenasCreated, !updateAgain);
+
+        if (sSolo3v3Workers->Release(*job) || updateAgain)
+            sBattlegroundMgr->ScheduleQueueUpdate(job->isRated ? 1 : 0, ARENA_TYPE_3v3_SOLO, bgQueueTypeId, job->bgTypeId, job->bracket_id);
+    }
+}
+
+void Solo3v3TeamSaverScript::OnUpdate(uint32 diff)
+{
+    sSolo3v3Saver->Update(diff);
+    sSolo3v3Rank->Update(diff);
+}
+
+void Solo3v3TeamSaverScript::OnShutdown()
+{
+    sSolo3v3Saver->Flush();
 }
 
 // n parece ser necessario, testei sem isso aqui e funcionou normalmente, talvez é necessario para ganho de arena point ou algo do tipo
@@ -688,8 +884,8 @@ void Team3v3arena::OnGetArenaPoints(ArenaTeam* at, float& points)
         const auto Members = at->GetMembers();
         uint8 playerLevel = sCharacterCache->GetCharacterLevelByGuid(Members.front().Guid);
 
-        if (playerLevel >= sConfigMgr->GetOption<uint32>("Solo.3v3.ArenaPointsMinLevel", 70))
-            points *= sConfigMgr->GetOption<float>("Solo.3v3.ArenaPointsMulti", 0.8f);
+        if (playerLevel >= sSolo3v3Config.ArenaPointsMinLevel)
+            points *= sSolo3v3Config.ArenaPointsMulti;
         else
             points *= 0;
     }
@@ -734,11 +930,11 @@ void PlayerScript3v3Arena::OnPlayerBattlegroundDesertion(Player* player, const B
             {
                 if (bg->GetStatus() == STATUS_WAIT_JOIN)
                 {
-                    if (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true) || sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true))
+                    if (sSolo3v3Config.CastDeserter())
                         player->CastSpell(player, 26013, true);
 
                     // end arena if a player leaves while in preparation
-                    if (sConfigMgr->GetOption<bool>("Solo.3v3.StopGameIncomplete", true))
+                    if (sSolo3v3Config.StopGameIncomplete)
                     {
                         bg->SetRated(false);
                         bg->EndBattleground(TEAM_NEUTRAL);
@@ -756,7 +952,7 @@ void PlayerScript3v3Arena::OnPlayerBattlegroundDesertion(Player* player, const B
 
             if (player->IsInvitedForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO))
             {
-                if (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true))
+                if (sSolo3v3Config.CastDeserterOnAfk)
                     player->CastSpell(player, 26013, true);
 
                 sSolo->CountAsLoss(player, false);
@@ -767,7 +963,7 @@ void PlayerScript3v3Arena::OnPlayerBattlegroundDesertion(Player* player, const B
 
             if (player->IsInvitedForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO))
             {
-                if (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true) || sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true))
+                if (sSolo3v3Config.CastDeserter())
                     player->CastSpell(player, 26013, true);
 
                 sSolo->CountAsLoss(player, false);
@@ -776,9 +972,13 @@ void PlayerScript3v3Arena::OnPlayerBattlegroundDesertion(Player* player, const B
 
         case ARENA_DESERTION_TYPE_LEAVE_QUEUE: // called if player uses macro to leave queue when it pops. /run AcceptBattlefieldPort(1, 0);
 
+            sSolo3v3QueueCounters->RemovePlayer(player->GetGUID());
+            if (sSolo3v3QueueIndex->RemovePlayer(player->GetGUID()))
+                sSolo3v3Trace->RecordPlayer(SOLO_3V3_TRACE_LEAVE, player->GetGUID());
+
             if (player->IsInvitedForBattlegroundQueueType((BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO))
             {
-                if (sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnAfk", true) || sConfigMgr->GetOption<bool>("Solo.3v3.CastDeserterOnLeave", true))
+                if (sSolo3v3Config.CastDeserter())
                     player->CastSpell(player, 26013, true);
                 sSolo->CountAsLoss(player, false);
             }
@@ -791,16 +991,43 @@ void PlayerScript3v3Arena::OnPlayerBattlegroundDesertion(Player* player, const B
 
 void PlayerScript3v3Arena::OnPlayerLogin(Player* pPlayer)
 {
-    if (sConfigMgr->GetOption<bool>("Solo.3v3.ShowMessageOnLogin", false)) {
+    if (sSolo3v3Config.ShowMessageOnLogin) {
         ChatHandler(pPlayer->GetSession()).SendSysMessage("This server is running the |cff4CFF00Arena solo Q 3v3 |rmodule.");
     }
 }
 
+void PlayerScript3v3Arena::OnPlayerLogout(Player* player)
+{
+    sSolo3v3QueueCounters->RemovePlayer(player->GetGUID());
+    if (sSolo3v3QueueIndex->RemovePlayer(player->GetGUID()))
+        sSolo3v3Trace->RecordPlayer(SOLO_3V3_TRACE_LEAVE, player->GetGUID());
+    sSolo->InvalidateTalentCat(player->GetGUID());
+}
+
+void PlayerScript3v3Arena::OnPlayerLearnTalents(Player* player, uint32 /*talentId*/, uint32 /*talentRank*/, uint32 /*spellid*/)
+{
+    sSolo->InvalidateTalentCat(player->GetGUID());
+    sSolo->RefreshQueuedRole(player);
+}
+
+void PlayerScript3v3Arena::OnPlayerTalentsReset(Player* player, bool /*noCost*/)
+{
+    sSolo->InvalidateTalentCat(player->GetGUID());
+    sSolo->RefreshQueuedRole(player);
+}
+
+// dual spec switch, a queued player must be matched with the role of the new spec
+void PlayerScript3v3Arena::OnPlayerAfterSpecSlotChanged(Player* player, uint8 /*newSlot*/)
+{
+    sSolo->InvalidateTalentCat(player->GetGUID());
+    sSolo->RefreshQueuedRole(player);
+}
+
 void PlayerScript3v3Arena::OnPlayerGetArenaPersonalRating(Player* player, uint8 slot, uint32& rating)
 {
     if (slot == ARENA_SLOT_SOLO_3v3)
     {
-        if (ArenaTeam* at = sArenaTeamMgr->GetArenaTeamByCaptain(player->GetGUID(), ARENA_TEAM_SOLO_3v3))
+        if (ArenaTeam* at = sSolo3v3Teams->GetTeamByCaptain(player->GetGUID()))
         {
             rating = at->GetRating();
         }
@@ -809,7 +1036,7 @@ void PlayerScript3v3Arena::OnPlayerGetArenaPersonalRating(Player* player, uint8
 
 void PlayerScript3v3Arena::OnPlayerGetMaxPersonalArenaRatingRequirement(const Player* player, uint32 minslot, uint32& maxArenaRating) const
 {
-    if (!sConfigMgr->GetOption<bool>("Solo.3v3.VendorRating", true))
+    if (!sSolo3v3Config.VendorRating)
     {
         return;
     }
@@ -817,7 +1044,7 @@ void PlayerScript3v3Arena::OnPlayerGetMaxPersonalArenaRatingRequirement(const Pl
     uint32 max_personal_rating = 0;
     for (uint8 i = minslot; i < MAX_ARENA_SLOT; ++i)
     {
-        if (i == 2 && !sConfigMgr->GetOption<bool>("Solo.3v3.VendorRating", true))
+        if (i == 2 && !sSolo3v3Config.VendorRating)
             continue;
 
         if (ArenaTeam* at = sArenaTeamMgr->GetArenaTeamById(player->GetArenaTeamId(i)))
@@ -833,36 +1060,60 @@ void PlayerScript3v3Arena::OnPlayerGetMaxPersonalArenaRatingRequirement(const Pl
 
     if (minslot < 6)
     {
-        if (ArenaTeam* at = sArenaTeamMgr->GetArenaTeamByCaptain(player->GetGUID(), ARENA_TEAM_SOLO_3v3))
+        if (ArenaTeam* at = sSolo3v3Teams->GetTeamByCaptain(player->GetGUID()))
         {
             maxArenaRating = std::max(at->GetRating(), maxArenaRating);
         }
     }
 }
 
+void PlayerScript3v3Arena::OnPlayerDelete(ObjectGuid guid, uint32 /*accountId*/)
+{
+    // the character leaves its teams without the arena team id field update
+    if (uint32 arenaTeamId = sSolo3v3Teams->GetTeamId(guid))
+    {
+        sSolo3v3Rank->CheckTeam(arenaTeamId);
+        sSolo3v3Teams->SetTeamId(guid, 0);
+    }
+}
+
 void PlayerScript3v3Arena::OnPlayerGetArenaTeamId(Player* player, uint8 slot, uint32& result)
 {
     if (!player)
         return;
 
     if (slot == ARENA_SLOT_SOLO_3v3)
-        result = player->GetArenaTeamIdFromDB(player->GetGUID(), ARENA_TEAM_SOLO_3v3); // important!
+    {
+        Solo3v3HookTimer timer(SOLO_3V3_HOOK_GET_ARENA_TEAM_ID);
+        result = sSolo3v3Teams->GetTeamId(player->GetGUID()); // important!
+    }
 }
 
-bool PlayerScript3v3Arena::OnPlayerNotSetArenaTeamInfoField(Player* player, uint8 slot, ArenaTeamInfoType /* type */, uint32 /* value */)
+bool PlayerScript3v3Arena::OnPlayerNotSetArenaTeamInfoField(Player* player, uint8 slot, ArenaTeamInfoType type, uint32 value)
 {
     if (!player)
         return false;
 
     if (slot == ARENA_SLOT_SOLO_3v3)
     {
-        return sConfigMgr->GetOption<bool>("Solo.3v3.ShowTeamInfo", true);
+        // called on team load, join and leave, keeps the cached team id of the player in sync
+        if (type == ARENA_TEAM_ID)
+        {
+            // a solo team without its member is disbanded, whichever way the player left it
+            if (!value)
+                if (uint32 oldTeamId = sSolo3v3Teams->GetTeamId(player->GetGUID()))
+                    sSolo3v3Rank->CheckTeam(oldTeamId);
+
+            sSolo3v3Teams->SetTeamId(player->GetGUID(), value);
+        }
+
+        return sSolo3v3Config.ShowTeamInfo;
     }
 
     return true;
 }
 
-bool PlayerScript3v3Arena::OnPlayerCanBattleFieldPort(Player* player, uint8 arenaType, BattlegroundTypeId BGTypeID, uint8 /*action*/)
+bool PlayerScript3v3Arena::OnPlayerCanBattleFieldPort(Player* player, uint8 arenaType, BattlegroundTypeId BGTypeID, uint8 action)
 {
     if (!player)
         return false;
@@ -871,6 +1122,10 @@ bool PlayerScript3v3Arena::OnPlayerCanBattleFieldPort(Player* player, uint8 aren
     if (bgQueueTypeId == BATTLEGROUND_QUEUE_NONE)
         return false;
 
+    // a leave without invite is a queue leave, recorded when the player is removed from the queue index
+    if (arenaType == ARENA_TYPE_3v3_SOLO && player->IsInvitedForBattlegroundQueueType(bgQueueTypeId))
+        sSolo3v3Trace->RecordPlayer(action == 1 ? SOLO_3V3_TRACE_ACCEPT : SOLO_3V3_TRACE_DECLINE, player->GetGUID());
+
     // if ((bgQueueTypeId == (BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_1v1 || bgQueueTypeId == (BattlegroundQueueTypeId)BATTLEGROUND_QUEUE_3v3_SOLO
     //     && (action == 1 /*accept join*/  && !sSolo->Arena1v1CheckTalents(player)))
     //     return false;
@@ -899,6 +1154,8 @@ void AddSC_Solo_3v3_Arena()
     new Solo3v3BG();
     new Team3v3arena();
     new ConfigLoader3v3Arena();
+    new Solo3v3QueueScheduler();
+    new Solo3v3TeamSaverScript();
     new PlayerScript3v3Arena();
     new Arena_SC();
     new Solo3v3Spell();
@@ -25,6 +25,8 @@
 #include "Config.h"
 #include "Battleground.h"
 #include "solo3v3.h"
+#include "solo3v3_match.h"
+#include "solo3v3_queue_counters.h"
 #include "Spell.h"
 
 #define NPC_TEXT_3v3 1000004
@@ -43,22 +45,25 @@ enum Npc3v3Actions {
 class NpcSolo3v3 : public CreatureScript
 {
 public:
-    NpcSolo3v3() : CreatureScript("npc_solo3v3")
-    {
-        Initialize();
-    }
+    NpcSolo3v3() : CreatureScript("npc_solo3v3") { }
 
-    void Initialize();
     bool OnGossipHello(Player* player, Creature* creature) override;
     bool OnGossipSelect(Player* player, Creature* creature, uint32 /*sender*/, uint32 action) override;
     bool ArenaCheckFullEquipAndTalents(Player* player);
     bool JoinQueueArena(Player* player, Creature* creature, bool isRated);
     bool CreateArenateam(Player* player, Creature* creature);
 
+    // Builds the queue status header text, without the cache of GetQueueInfo
+    static std::string RenderQueueInfo(bool MeleeCasterHealer, Solo3v3QueueCounts const& counts);
+
 private:
-    void fetchQueueList();
-    int cache3v3Queue[MAX_TALENT_CAT];
-    uint32 lastFetchQueueList;
+    // Queue status header of the gossip menu, only rebuilt when the queue counters or MeleeCasterHealer changed
+    std::string GetQueueInfo(bool MeleeCasterHealer);
+
+    std::string queueInfo;
+    uint32 queueInfoVersion = 0;
+    bool queueInfoMeleeCasterHealer = false;
+    std::mutex queueInfoLock;
 };
 
 class Solo3v3BG : public AllBattlegroundScript
@@ -75,6 +80,12 @@ public:
     bool OnQueueUpdateValidity(BattlegroundQueue* /* queue */, uint32 /*diff*/, BattlegroundTypeId /* bgTypeId */, BattlegroundBracketId /* bracket_id */, uint8 arenaType, bool /* isRated */, uint32 /*arenaRatedTeamId*/) override;
     void OnBattlegroundDestroy(Battleground* bg) override;
     void OnBattlegroundEndReward(Battleground* bg, Player* player, TeamId /* winnerTeamId */) override;
+
+    // Creates the arena for the groups in the selection pools and invites them
+    static bool CreateSolo3v3Arena(BattlegroundQueue* queue, BattlegroundTypeId bgTypeId, PvPDifficultyEntry const* bracketEntry, uint8 arenaType, bool isRated);
+
+    // Rating, stats and MMR of every player of the match, with a single rank update and save batch
+    void SettleSolo3v3Match(Battleground* bg, TeamId winnerTeamId, Solo3v3MatchContext const& matchContext);
 };
 
 class ConfigLoader3v3Arena : public WorldScript
@@ -87,6 +98,37 @@ public:
     virtual void OnAfterConfigLoad(bool /*Reload*/) override;
 };
 
+class Solo3v3QueueScheduler : public WorldScript
+{
+public:
+    Solo3v3QueueScheduler() : WorldScript("solo3v3_queue_scheduler", {
+        WORLDHOOK_ON_UPDATE,
+        WORLDHOOK_ON_SHUTDOWN
+    }), updateTimer(0) {}
+
+    // queue updates are normally only scheduled on join, re-check periodically so MMR windows can widen
+    void OnUpdate(uint32 diff) override;
+    void OnShutdown() override;
+
+private:
+    // Creates the arenas selected by the matchmaking workers, after checking their players are still queued
+    void CommitWorkerMatches();
+
+    uint32 updateTimer;
+};
+
+class Solo3v3TeamSaverScript : public WorldScript
+{
+public:
+    Solo3v3TeamSaverScript() : WorldScript("solo3v3_team_saver", {
+        WORLDHOOK_ON_UPDATE,
+        WORLDHOOK_ON_SHUTDOWN
+    }) {}
+
+    void OnUpdate(uint32 diff) override;
+    void OnShutdown() override;
+};
+
 class Team3v3arena : public ArenaTeamScript
 {
 public:
@@ -108,21 +150,31 @@ class PlayerScript3v3Arena : public PlayerScript
 public:
     PlayerScript3v3Arena() : PlayerScript("player_script_3v3_arena", {
         PLAYERHOOK_ON_LOGIN,
+        PLAYERHOOK_ON_LOGOUT,
+        PLAYERHOOK_ON_LEARN_TALENTS,
+        PLAYERHOOK_ON_TALENTS_RESET,
+        PLAYERHOOK_ON_AFTER_SPEC_SLOT_CHANGED,
         PLAYERHOOK_ON_GET_ARENA_PERSONAL_RATING,
         PLAYERHOOK_ON_GET_MAX_PERSONAL_ARENA_RATING_REQUIREMENT,
         PLAYERHOOK_ON_GET_ARENA_TEAM_ID,
         PLAYERHOOK_NOT_SET_ARENA_TEAM_INFO_FIELD,
         PLAYERHOOK_CAN_BATTLEFIELD_PORT,
-        PLAYERHOOK_ON_BATTLEGROUND_DESERTION
+        PLAYERHOOK_ON_BATTLEGROUND_DESERTION,
+        PLAYERHOOK_ON_DELETE
     }) {}
 
     void OnPlayerLogin(Player* pPlayer) override;
+    void OnPlayerLogout(Player* player) override;
+    void OnPlayerLearnTalents(Player* player, uint32 talentId, uint32 talentRank, uint32 spellid) override;
+    void OnPlayerTalentsReset(Player* player, bool noCost) override;
+    void OnPlayerAfterSpecSlotChanged(Player* player, uint8 newSlot) override;
     void OnPlayerGetArenaPersonalRating(Player* player, uint8 slot, uint32& rating) override;
     void OnPlayerGetMaxPersonalArenaRatingRequirement(const Player* player, uint32 minslot, uint32& maxArenaRating) const override;
     void OnPlayerGetArenaTeamId(Player* player, uint8 slot, uint32& result) override;
     bool OnPlayerNotSetArenaTeamInfoField(Player* player, uint8 slot, ArenaTeamInfoType type, uint32 value) override;
     bool OnPlayerCanBattleFieldPort(Player* player, uint8 arenaType, BattlegroundTypeId BGTypeID, uint8 action) override;
     void OnPlayerBattlegroundDesertion(Player* player, const BattlegroundDesertionType type) override;
+    void OnPlayerDelete(ObjectGuid guid, uint32 accountId) override;
 };
 
 class Arena_SC : public ArenaScript
@@ -0,0 +1,283 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_simulator.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <unordered_map>
+
+namespace
+{
+    uint32 Percentile(std::vector<uint32>& values, uint32 percent)
+    {
+        if (values.empty())
+            return 0;
+
+        std::size_t index = std::min(values.size() - 1, values.size() * percent / 100);
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    // queued players in join order, the arrays are indexed like the candidates
+    struct SimulatedQueue
+    {
+        std::vector<Solo3v3Candidate> candidates;
+        std::vector<uint32> joinTimes;
+        std::vector<uint32> players; // guid counter of the traced player, 0 for synthetic players
+
+        void Erase(std::size_t index)
+        {
+            candidates.erase(candidates.begin() + index);
+            joinTimes.erase(joinTimes.begin() + index);
+            players.erase(players.begin() + index);
+        }
+    };
+
+    // Forms matches until the selection finds none, returns how many were formed
+    uint32 FormMatches(SimulatedQueue& queue, bool isRated, Solo3v3MatchSettings const& settings, uint32 now, std::mt19937& rng, std::vector<uint32>& waitTimes, std::vector<uint32>* matchedPlayers = nullptr)
+    {
+        for (std::size_t i = 0; i < queue.candidates.size(); ++i)
+            queue.candidates[i].waitTime = now - queue.joinTimes[i];
+
+        uint32 matches = 0;
+
+        while (true)
+        {
+            Solo3v3MatchSelection selected;
+            if (!sSolo->SelectSolo3v3Match(queue.candidates, isRated, settings, selected, &rng))
+                break;
+
+            std::vector<std::size_t> chosen;
+            for (uint8 teamId = TEAM_ALLIANCE; teamId < BG_TEAMS_COUNT; ++teamId)
+                for (Solo3v3Candidate const* candidate : selected[teamId])
+                    chosen.push_back(candidate - queue.candidates.data());
+
+            // erase from the back so the other indexes stay valid
+            std::sort(chosen.begin(), chosen.end(), std::greater<std::size_t>());
+            for (std::size_t index : chosen)
+            {
+                waitTimes.push_back(now - queue.joinTimes[index]);
+                if (matchedPlayers)
+                    matchedPlayers->push_back(queue.players[index]);
+
+                queue.Erase(index);
+            }
+
+            ++matches;
+        }
+
+        return matches;
+    }
+}
+
+Solo3v3Candidate Solo3v3Simulator::MakeCandidate(Solo3v3SimulationSettings const& settings, std::mt19937& rng)
+{
+    std::uniform_int_distribution<uint32> roleRoll(0, 99);
+    std::normal_distribution<double> mmrRoll(settings.mmrMean, settings.mmrDeviation);
+
+    uint32 roll = roleRoll(rng);
+
+    Solo3v3Candidate candidate = { };
+    candidate.role = roll < settings.healerPercent ? HEALER : (roll < settings.healerPercent + settings.meleePercent ? MELEE : RANGE);
+    candidate.mmr = uint32(std::max(0.0, mmrRoll(rng)));
+
+    return candidate;
+}
+
+Solo3v3SimulationResult Solo3v3Simulator::Run(Solo3v3SimulationSettings const& settings)
+{
+    Solo3v3SimulationResult result;
+
+    std::mt19937 rng(settings.seed);
+    Solo3v3MatchSettings matchSettings = sSolo->GetMatchSettings();
+
+    SimulatedQueue queue;
+    std::vector<uint32> tickTimes;
+    std::vector<uint32> waitTimes;
+
+    uint32 arrived = 0;
+    uint32 now = 0;
+    std::size_t capacity = 0;
+    auto runStart = std::chrono::steady_clock::now();
+
+    while (true)
+    {
+        for (uint32 i = 0; i < settings.arrivalsPerTick && arrived < settings.players; ++i, ++arrived)
+        {
+            Solo3v3Candidate candidate = MakeCandidate(settings, rng);
+            candidate.queueIndex = i % BG_TEAMS_COUNT;
+
+            queue.candidates.push_back(candidate);
+            queue.joinTimes.push_back(now);
+            queue.players.push_back(0);
+
+            if (queue.candidates.capacity() != capacity)
+            {
+                capacity = queue.candidates.capacity();
+                ++result.snapshotReallocations;
+            }
+        }
+
+        auto tickStart = std::chrono::steady_clock::now();
+        uint32 matchesThisTick = FormMatches(queue, settings.isRated, matchSettings, now, rng, waitTimes);
+
+        uint32 elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tickStart).count();
+        tickTimes.push_back(elapsed);
+        result.totalTime += elapsed;
+        result.matches += matchesThisTick;
+        ++result.ticks;
+
+        now += settings.tickTime;
+
+        // everyone arrived and nothing can be matched anymore
+        if (arrived >= settings.players && !matchesThisTick)
+            break;
+
+        if (settings.timeLimit && std::chrono::steady_clock::now() - runStart >= std::chrono::milliseconds(settings.timeLimit))
+        {
+            result.timedOut = true;
+            break;
+        }
+    }
+
+    result.arrived = arrived;
+    result.unmatched = queue.candidates.size();
+
+    result.tickP50 = Percentile(tickTimes, 50);
+    result.tickP99 = Percentile(tickTimes, 99);
+    result.tickMax = tickTimes.empty() ? 0 : *std::max_element(tickTimes.begin(), tickTimes.end());
+
+    result.waitP50 = Percentile(waitTimes, 50);
+    result.waitP90 = Percentile(waitTimes, 90);
+    result.waitP99 = Percentile(waitTimes, 99);
+
+    return result;
+}
+
+Solo3v3ReplayResult Solo3v3Simulator::Replay(std::vector<Solo3v3TraceRecord> const& records, uint32 seed, uint32 tickTime)
+{
+    Solo3v3ReplayResult result;
+    result.events = records.size();
+
+    if (records.empty() || !tickTime)
+        return result;
+
+    std::mt19937 rng(seed);
+    Solo3v3MatchSettings matchSettings = sSolo->GetMatchSettings();
+
+    // one queue per bracket and rating, in an ordered map so the queues are always matched in the same order
+    std::map<std::pair<uint8, uint8>, SimulatedQueue> queues;
+    std::unordered_map<uint32, std::pair<uint8, uint8>> queuedIn; // player -> queue in the replay
+    std::unordered_map<uint32, uint32> recordedJoins;             // player -> join time in the trace
+    std::vector<uint32> recordedWaits;
+    std::vector<uint32> replayedWaits;
+
+    auto removeFromReplay = [&](uint32 player)
+    {
+        auto itr = queuedIn.find(player);
+        if (itr == queuedIn.end())
+            return; // already matched in the replay
+
+        SimulatedQueue& queue = queues[itr->second];
+        auto position = std::find(queue.players.begin(), queue.players.end(), player);
+        if (position != queue.players.end())
+            queue.Erase(position - queue.players.begin());
+
+        queuedIn.erase(itr);
+    };
+
+    std::size_t next = 0;
+    uint32 now = records.front().time;
+
+    while (next < records.size())
+    {
+        for (; next < records.size() && records[next].time <= now; ++next)
+        {
+            Solo3v3TraceRecord const& record = records[next];
+
+            switch (record.type)
+            {
+                case SOLO_3V3_TRACE_JOIN:
+                {
+                    ++result.joins;
+                    recordedJoins[record.player] = record.time;
+
+                    if (queuedIn.count(record.player))
+                        break;
+
+                    Solo3v3Candidate candidate = { };
+                    candidate.queueIndex = record.team;
+                    candidate.role = Solo3v3TalentCat(record.role);
+                    candidate.mmr = record.mmr;
+
+                    std::pair<uint8, uint8> key(record.bracket, record.isRated);
+                    SimulatedQueue& queue = queues[key];
+                    queue.candidates.push_back(candidate);
+                    queue.joinTimes.push_back(record.time);
+                    queue.players.push_back(record.player);
+                    queuedIn[record.player] = key;
+                    break;
+                }
+                case SOLO_3V3_TRACE_LEAVE:
+                case SOLO_3V3_TRACE_DECLINE:
+                    ++result.leaves;
+                    recordedJoins.erase(record.player);
+                    removeFromReplay(record.player);
+                    break;
+                case SOLO_3V3_TRACE_INVITE:
+                {
+                    auto itr = recordedJoins.find(record.player);
+                    if (itr != recordedJoins.end())
+                    {
+                        recordedWaits.push_back(record.time - itr->second);
+                        recordedJoins.erase(itr);
+                    }
+                    break;
+                }
+                case SOLO_3V3_TRACE_MATCH_FORMED:
+                    ++result.recordedMatches;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        std::vector<uint32> matchedPlayers;
+        for (auto& [key, queue] : queues)
+            result.replayedMatches += FormMatches(queue, key.second, matchSettings, now, rng, replayedWaits, &matchedPlayers);
+
+        // a later leave or decline of a player matched in the replay doesn't apply anymore
+        for (uint32 player : matchedPlayers)
+            queuedIn.erase(player);
+
+        now += tickTime;
+        ++result.ticks;
+    }
+
+    result.unmatched = queuedIn.size();
+
+    result.recordedWaitP50 = Percentile(recordedWaits, 50);
+    result.recordedWaitP90 = Percentile(recordedWaits, 90);
+    result.recordedWaitP99 = Percentile(recordedWaits, 99);
+
+    result.replayedWaitP50 = Percentile(replayedWaits, 50);
+    result.replayedWaitP90 = Percentile(replayedWaits, 90);
+    result.replayedWaitP99 = Percentile(replayedWaits, 99);
+
+    return result;
+}
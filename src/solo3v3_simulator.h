@@ -0,0 +1,82 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_SIMULATOR_H_
+#define _SOLO_3V3_SIMULATOR_H_
+
+#include "solo3v3.h"
+#include "solo3v3_trace.h"
+#include <random>
+
+struct Solo3v3SimulationSettings
+{
+    uint32 players = 600;
+    uint32 healerPercent = 20;
+    uint32 meleePercent = 40;   // the rest are ranged
+    uint32 mmrMean = 1500;
+    uint32 mmrDeviation = 200;
+    uint32 arrivalsPerTick = 20;
+    uint32 tickTime = 1000;     // ms of queue time per tick
+    bool isRated = true;
+    uint32 seed = 1;
+    uint32 timeLimit = 2000;    // ms, the run stops once it took this long (it runs on the world thread)
+};
+
+struct Solo3v3SimulationResult
+{
+    uint32 matches = 0;
+    uint32 unmatched = 0;
+    uint32 arrived = 0;
+    uint32 ticks = 0;
+    bool timedOut = false;      // stopped on the time limit before the queue drained
+    uint64 totalTime = 0;       // us spent in the matcher
+    uint32 tickP50 = 0, tickP99 = 0, tickMax = 0;      // us
+    uint32 waitP50 = 0, waitP90 = 0, waitP99 = 0;      // ms of simulated queue time
+    uint32 snapshotReallocations = 0;                  // capacity growths of the candidate vector, not all allocations
+};
+
+struct Solo3v3ReplayResult
+{
+    uint32 events = 0;
+    uint32 joins = 0;
+    uint32 leaves = 0;          // leaves and declines
+    uint32 ticks = 0;
+    uint32 recordedMatches = 0, replayedMatches = 0;
+    uint32 unmatched = 0;       // still queued in the replay when the trace ends
+    uint32 recordedWaitP50 = 0, recordedWaitP90 = 0, recordedWaitP99 = 0; // ms from join to invite
+    uint32 replayedWaitP50 = 0, replayedWaitP90 = 0, replayedWaitP99 = 0;
+};
+
+// Replays a synthetic solo queue through the real match selection (Solo3v3::SelectSolo3v3Match) with the
+// current settings, without touching the battleground queues. Players arrive at a fixed rate with random
+// roles and a normal MMR distribution, and every tick forms as many matches as possible.
+// Only the selection is simulated: no temp arena teams, invites or rating and rank updates of the match end.
+class Solo3v3Simulator
+{
+public:
+    static Solo3v3SimulationResult Run(Solo3v3SimulationSettings const& settings);
+
+    // Feeds a recorded trace (see Solo3v3TraceRecorder) through the match selection. Joins, leaves and declines
+    // are applied at their recorded time and matches are formed every tickTime ms of trace time, with a
+    // seeded RNG instead of urand, so the same trace, seed and settings always give the same result.
+    static Solo3v3ReplayResult Replay(std::vector<Solo3v3TraceRecord> const& records, uint32 seed, uint32 tickTime = 1000);
+
+    // Random role and MMR following the settings, the waitTime is left at 0
+    static Solo3v3Candidate MakeCandidate(Solo3v3SimulationSettings const& settings, std::mt19937& rng);
+};
+
+#endif // _SOLO_3V3_SIMULATOR_H_
@@ -0,0 +1,171 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_stats.h"
+#include <algorithm>
+#include <bit>
+#include <memory>
+
+struct Solo3v3ThreadHistograms
+{
+    typedef std::array<std::array<std::atomic<uint64>, SOLO_3V3_STATS_BUCKETS>, MAX_SOLO_3V3_HOOKS> Counts;
+
+    // on the heap, a large thread_local would use up the static TLS of the module
+    std::unique_ptr<Counts> counts;
+
+    Solo3v3ThreadHistograms() : counts(std::make_unique<Counts>())
+    {
+        std::lock_guard<std::mutex> guard(sSolo3v3HookStats->lock);
+        sSolo3v3HookStats->threads.push_back(this);
+    }
+
+    ~Solo3v3ThreadHistograms()
+    {
+        Solo3v3HookStatsMgr* mgr = sSolo3v3HookStats;
+        std::lock_guard<std::mutex> guard(mgr->lock);
+
+        for (uint8 hook = 0; hook < MAX_SOLO_3V3_HOOKS; ++hook)
+            for (uint32 i = 0; i < SOLO_3V3_STATS_BUCKETS; ++i)
+                mgr->exited[hook][i] += (*counts)[hook][i].load(std::memory_order_relaxed);
+
+        mgr->threads.erase(std::remove(mgr->threads.begin(), mgr->threads.end(), this), mgr->threads.end());
+    }
+};
+
+namespace
+{
+    char const* const HookNames[MAX_SOLO_3V3_HOOKS] =
+    {
+        "OnQueueUpdate",
+        "CheckSolo3v3Arena",
+        "OnBattlegroundEndReward",
+        "CountAsLoss",
+        "GetQueueInfo",
+        "OnPlayerGetArenaTeamId",
+    };
+
+    uint64 Percentile(Solo3v3Histogram const& histogram, uint64 total, uint32 percent)
+    {
+        // rank of the value, 1 based, rounded up
+        uint64 rank = std::max<uint64>(1, (total * percent + 99) / 100);
+        uint64 seen = 0;
+
+        for (uint32 i = 0; i < SOLO_3V3_STATS_BUCKETS; ++i)
+        {
+            seen += histogram[i];
+            if (seen >= rank)
+                return Solo3v3HookStatsMgr::BucketValue(i);
+        }
+
+        return 0;
+    }
+}
+
+Solo3v3HookStatsMgr::Solo3v3HookStatsMgr() : resetTime(std::chrono::steady_clock::now()) { }
+
+Solo3v3HookStatsMgr* Solo3v3HookStatsMgr::instance()
+{
+    static Solo3v3HookStatsMgr instance;
+    return &instance;
+}
+
+uint32 Solo3v3HookStatsMgr::BucketIndex(uint64 ns)
+{
+    constexpr uint64 maxValue = (uint64(SOLO_3V3_STATS_SUB_BUCKETS) << (SOLO_3V3_STATS_MAX_SHIFT + 1)) - 1;
+    ns = std::min(ns, maxValue);
+
+    // values below 2 * SUB_BUCKETS get their own bucket, above the 16 sub buckets of a power of two get wider
+    uint32 msb = std::bit_width(ns | 1) - 1;
+    uint32 shift = msb > 4 ? msb - 4 : 0;
+
+    return shift * SOLO_3V3_STATS_SUB_BUCKETS + uint32(ns >> shift);
+}
+
+uint64 Solo3v3HookStatsMgr::BucketValue(uint32 index)
+{
+    uint32 shift = index < 2 * SOLO_3V3_STATS_SUB_BUCKETS ? 0 : index / SOLO_3V3_STATS_SUB_BUCKETS - 1;
+    uint64 sub = index - shift * SOLO_3V3_STATS_SUB_BUCKETS;
+
+    // highest value of the bucket
+    return ((sub + 1) << shift) - 1;
+}
+
+void Solo3v3HookStatsMgr::Record(Solo3v3StatsHook hook, uint64 ns)
+{
+    thread_local Solo3v3ThreadHistograms histograms;
+
+    // only this thread writes the counter, no need for a locked add
+    std::atomic<uint64>& counter = (*histograms.counts)[hook][BucketIndex(ns)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void Solo3v3HookStatsMgr::Merge(HookHistograms& merged)
+{
+    merged = exited;
+
+    for (Solo3v3ThreadHistograms* thread : threads)
+        for (uint8 hook = 0; hook < MAX_SOLO_3V3_HOOKS; ++hook)
+            for (uint32 i = 0; i < SOLO_3V3_STATS_BUCKETS; ++i)
+                merged[hook][i] += (*thread->counts)[hook][i].load(std::memory_order_relaxed);
+}
+
+std::vector<Solo3v3HookStats> Solo3v3HookStatsMgr::GetStats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    HookHistograms merged;
+    Merge(merged);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - resetTime).count();
+
+    std::vector<Solo3v3HookStats> stats;
+    for (uint8 hook = 0; hook < MAX_SOLO_3V3_HOOKS; ++hook)
+    {
+        Solo3v3Histogram histogram;
+        uint64 calls = 0;
+        uint64 max = 0;
+
+        for (uint32 i = 0; i < SOLO_3V3_STATS_BUCKETS; ++i)
+        {
+            histogram[i] = merged[hook][i] - baseline[hook][i];
+            calls += histogram[i];
+
+            if (histogram[i])
+                max = BucketValue(i);
+        }
+
+        Solo3v3HookStats hookStats;
+        hookStats.name = HookNames[hook];
+        hookStats.calls = calls;
+        hookStats.callsPerSecond = seconds > 0 ? calls / seconds : 0.0;
+        hookStats.p50 = calls ? Percentile(histogram, calls, 50) : 0;
+        hookStats.p99 = calls ? Percentile(histogram, calls, 99) : 0;
+        hookStats.max = max;
+
+        stats.push_back(hookStats);
+    }
+
+    return stats;
+}
+
+void Solo3v3HookStatsMgr::Reset()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    Merge(baseline);
+    resetTime = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,108 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_STATS_H_
+#define _SOLO_3V3_STATS_H_
+
+#include "Common.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+enum Solo3v3StatsHook : uint8
+{
+    SOLO_3V3_HOOK_QUEUE_UPDATE,
+    SOLO_3V3_HOOK_CHECK_ARENA,
+    SOLO_3V3_HOOK_END_REWARD,
+    SOLO_3V3_HOOK_COUNT_AS_LOSS,
+    SOLO_3V3_HOOK_QUEUE_INFO,
+    SOLO_3V3_HOOK_GET_ARENA_TEAM_ID,
+    MAX_SOLO_3V3_HOOKS
+};
+
+// HDR style log-linear buckets over nanoseconds: exact below 32 ns, then 16 buckets per power of two
+// (at most 1/16 relative error) up to 2^41 ns.
+constexpr uint32 SOLO_3V3_STATS_SUB_BUCKETS = 16;
+constexpr uint32 SOLO_3V3_STATS_MAX_SHIFT = 36;
+constexpr uint32 SOLO_3V3_STATS_BUCKETS = SOLO_3V3_STATS_SUB_BUCKETS * (SOLO_3V3_STATS_MAX_SHIFT + 2);
+
+typedef std::array<uint64, SOLO_3V3_STATS_BUCKETS> Solo3v3Histogram;
+
+struct Solo3v3ThreadHistograms;
+
+struct Solo3v3HookStats
+{
+    char const* name;
+    uint64 calls;
+    double callsPerSecond;
+    uint64 p50, p99, max; // ns, bucket precision
+};
+
+// Per thread histograms of the module hooks. A thread only writes its own buffer, with relaxed atomics
+// so a read from another thread is not a data race, and reads merge the buffers of every thread.
+// A reset keeps the current totals as a baseline instead of clearing buffers owned by other threads.
+class Solo3v3HookStatsMgr
+{
+public:
+    static Solo3v3HookStatsMgr* instance();
+
+    void Record(Solo3v3StatsHook hook, uint64 ns);
+
+    std::vector<Solo3v3HookStats> GetStats();
+    void Reset();
+
+    static uint32 BucketIndex(uint64 ns);
+    static uint64 BucketValue(uint32 index);
+
+private:
+    friend struct Solo3v3ThreadHistograms;
+
+    Solo3v3HookStatsMgr();
+
+    typedef std::array<Solo3v3Histogram, MAX_SOLO_3V3_HOOKS> HookHistograms;
+
+    // totals of the live threads, the exited ones and minus the baseline
+    void Merge(HookHistograms& merged);
+
+    std::vector<Solo3v3ThreadHistograms*> threads;
+    HookHistograms exited{};   // folded in when a thread ends
+    HookHistograms baseline{}; // totals at the last reset
+    std::chrono::steady_clock::time_point resetTime;
+    std::mutex lock;
+};
+
+#define sSolo3v3HookStats Solo3v3HookStatsMgr::instance()
+
+// Times a scope into the hook histogram, costs two steady_clock reads
+class Solo3v3HookTimer
+{
+public:
+    explicit Solo3v3HookTimer(Solo3v3StatsHook hook) : hook(hook), start(std::chrono::steady_clock::now()) { }
+
+    ~Solo3v3HookTimer()
+    {
+        sSolo3v3HookStats->Record(hook, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    Solo3v3StatsHook hook;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // _SOLO_3V3_STATS_H_
@@ -0,0 +1,126 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_teams.h"
+#include "solo3v3.h"
+#include "ArenaTeamMgr.h"
+#include <mutex>
+
+Solo3v3TeamCache* Solo3v3TeamCache::instance()
+{
+    static Solo3v3TeamCache instance;
+    return &instance;
+}
+
+uint32 Solo3v3TeamCache::GetTeamId(ObjectGuid guid)
+{
+    {
+        std::shared_lock<std::shared_mutex> guard(lock);
+
+        if (built)
+        {
+            auto itr = teamIds.find(guid);
+            return itr != teamIds.end() ? itr->second : 0;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> guard(lock);
+    BuildIfNeeded();
+
+    auto itr = teamIds.find(guid);
+    return itr != teamIds.end() ? itr->second : 0;
+}
+
+void Solo3v3TeamCache::SetTeamId(ObjectGuid guid, uint32 arenaTeamId)
+{
+    // temp teams of running solo matches are never stored
+    if (arenaTeamId >= MAX_ARENA_TEAM_ID)
+        return;
+
+    std::unique_lock<std::shared_mutex> guard(lock);
+    BuildIfNeeded();
+
+    if (arenaTeamId)
+    {
+        teamIds[guid] = arenaTeamId;
+
+        ArenaTeam* arenaTeam = sArenaTeamMgr->GetArenaTeamById(arenaTeamId);
+        if (arenaTeam && arenaTeam->GetCaptain() == guid)
+            captainTeamIds[guid] = arenaTeamId;
+    }
+    else
+    {
+        teamIds.erase(guid);
+        captainTeamIds.erase(guid);
+    }
+}
+
+ArenaTeam* Solo3v3TeamCache::GetTeamByCaptain(ObjectGuid guid)
+{
+    uint32 arenaTeamId = 0;
+
+    {
+        std::shared_lock<std::shared_mutex> guard(lock);
+
+        if (built)
+        {
+            auto itr = captainTeamIds.find(guid);
+            if (itr == captainTeamIds.end())
+                return nullptr;
+
+            arenaTeamId = itr->second;
+        }
+    }
+
+    if (!arenaTeamId)
+    {
+        std::unique_lock<std::shared_mutex> guard(lock);
+        BuildIfNeeded();
+
+        auto itr = captainTeamIds.find(guid);
+        if (itr == captainTeamIds.end())
+            return nullptr;
+
+        arenaTeamId = itr->second;
+    }
+
+    // resolved by id, a team disbanded behind our back just isn't found anymore
+    ArenaTeam* arenaTeam = sArenaTeamMgr->GetArenaTeamById(arenaTeamId);
+    if (!arenaTeam || arenaTeam->GetCaptain() != guid)
+        return nullptr;
+
+    return arenaTeam;
+}
+
+void Solo3v3TeamCache::BuildIfNeeded()
+{
+    if (built)
+        return;
+
+    built = true;
+
+    for (ArenaTeamMgr::ArenaTeamContainer::const_iterator itr = sArenaTeamMgr->GetArenaTeamMapBegin(); itr != sArenaTeamMgr->GetArenaTeamMapEnd(); ++itr)
+    {
+        if (itr->second->GetType() != ARENA_TEAM_SOLO_3v3 || itr->first >= MAX_ARENA_TEAM_ID)
+            continue;
+
+        for (ArenaTeamMember const& member : itr->second->GetMembers())
+            teamIds[member.Guid] = itr->first;
+
+        captainTeamIds[itr->second->GetCaptain()] = itr->first;
+    }
+}
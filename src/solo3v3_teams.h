@@ -0,0 +1,51 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_TEAMS_H_
+#define _SOLO_3V3_TEAMS_H_
+
+#include "Common.h"
+#include "ArenaTeam.h"
+#include "ObjectGuid.h"
+#include <shared_mutex>
+#include <unordered_map>
+
+// In-memory player GUID -> solo 3v3 arena team id map, so the arena team id hook doesn't query the database,
+// and captain GUID -> solo team index replacing the ArenaTeamMgr::GetArenaTeamByCaptain scans.
+// Built from sArenaTeamMgr on first use and kept in sync through the solo slot ARENA_TEAM_ID field updates.
+class Solo3v3TeamCache
+{
+public:
+    static Solo3v3TeamCache* instance();
+
+    uint32 GetTeamId(ObjectGuid guid);
+    void SetTeamId(ObjectGuid guid, uint32 arenaTeamId);
+
+    ArenaTeam* GetTeamByCaptain(ObjectGuid guid);
+
+private:
+    void BuildIfNeeded();
+
+    std::unordered_map<ObjectGuid, uint32> teamIds;
+    std::unordered_map<ObjectGuid, uint32> captainTeamIds;
+    std::shared_mutex lock;
+    bool built = false;
+};
+
+#define sSolo3v3Teams Solo3v3TeamCache::instance()
+
+#endif // _SOLO_3V3_TEAMS_H_
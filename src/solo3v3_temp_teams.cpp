@@ -0,0 +1,55 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_temp_teams.h"
+#include "solo3v3.h"
+#include "ArenaTeamMgr.h"
+#include "Player.h"
+
+Solo3v3TempTeamPool* Solo3v3TempTeamPool::instance()
+{
+    static Solo3v3TempTeamPool instance;
+    return &instance;
+}
+
+ArenaTeam* Solo3v3TempTeamPool::Acquire(std::vector<Player*> const& playersList, std::string const& teamName)
+{
+    ArenaTeam* team = new ArenaTeam(); // stored in sArenaTeamMgr until Release
+    team->CreateTempArenaTeam(playersList, ARENA_TEAM_SOLO_3v3, teamName);
+    sArenaTeamMgr->AddArenaTeam(team);
+
+    std::lock_guard<std::mutex> guard(lock);
+    ++inUse;
+    ++created;
+
+    return team;
+}
+
+void Solo3v3TempTeamPool::Release(ArenaTeam* arenaTeam)
+{
+    sArenaTeamMgr->RemoveArenaTeam(arenaTeam->GetId());
+    delete arenaTeam;
+
+    std::lock_guard<std::mutex> guard(lock);
+    --inUse;
+}
+
+Solo3v3TempTeamPoolStats Solo3v3TempTeamPool::GetStats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return { inUse, created };
+}
@@ -0,0 +1,59 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_TEMP_TEAMS_H_
+#define _SOLO_3V3_TEMP_TEAMS_H_
+
+#include "Common.h"
+#include "ArenaTeam.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Player;
+
+struct Solo3v3TempTeamPoolStats
+{
+    uint32 inUse;
+    uint32 created; // temp team ids taken from sArenaTeamMgr
+};
+
+// Owns the temp arena teams of solo matches. Teams are built through ArenaTeam::CreateTempArenaTeam,
+// which takes a new temp id and appends to the member list, so neither the ids nor the objects can be
+// reused without a reset API in ArenaTeam; every match allocates its teams and Release deletes them.
+class Solo3v3TempTeamPool
+{
+public:
+    static Solo3v3TempTeamPool* instance();
+
+    // Creates a temp team for the players and registers it in sArenaTeamMgr
+    ArenaTeam* Acquire(std::vector<Player*> const& playersList, std::string const& teamName);
+
+    // Unregisters the team from sArenaTeamMgr and deletes it
+    void Release(ArenaTeam* arenaTeam);
+
+    Solo3v3TempTeamPoolStats GetStats();
+
+private:
+    std::mutex lock;
+    uint32 inUse = 0;
+    uint32 created = 0;
+};
+
+#define sSolo3v3TempTeams Solo3v3TempTeamPool::instance()
+
+#endif // _SOLO_3V3_TEMP_TEAMS_H_
@@ -0,0 +1,150 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_trace.h"
+#include "solo3v3_config.h"
+#include "GameTime.h"
+#include "Log.h"
+
+Solo3v3TraceRecorder* Solo3v3TraceRecorder::instance()
+{
+    static Solo3v3TraceRecorder instance;
+    return &instance;
+}
+
+void Solo3v3TraceRecorder::RecordJoin(ObjectGuid guid, uint8 bracket, bool isRated, uint8 role, uint8 playerClass, uint8 team, uint32 mmr)
+{
+    if (!sSolo3v3Config.TraceEnable)
+        return;
+
+    Solo3v3TraceRecord record = { };
+    record.type = SOLO_3V3_TRACE_JOIN;
+    record.bracket = bracket;
+    record.isRated = isRated ? 1 : 0;
+    record.role = role;
+    record.playerClass = playerClass;
+    record.team = team;
+    record.player = guid.GetCounter();
+    record.mmr = mmr;
+
+    Record(record);
+}
+
+void Solo3v3TraceRecorder::RecordPlayer(Solo3v3TraceEventType type, ObjectGuid guid, uint32 instanceId, uint8 team)
+{
+    if (!sSolo3v3Config.TraceEnable)
+        return;
+
+    Solo3v3TraceRecord record = { };
+    record.type = type;
+    record.team = team;
+    record.player = guid.GetCounter();
+    record.instanceId = instanceId;
+
+    Record(record);
+}
+
+void Solo3v3TraceRecorder::RecordMatch(uint32 instanceId, uint8 bracket, bool isRated, uint32 mmrGap)
+{
+    if (!sSolo3v3Config.TraceEnable)
+        return;
+
+    Solo3v3TraceRecord record = { };
+    record.type = SOLO_3V3_TRACE_MATCH_FORMED;
+    record.bracket = bracket;
+    record.isRated = isRated ? 1 : 0;
+    record.mmr = mmrGap;
+    record.instanceId = instanceId;
+
+    Record(record);
+}
+
+void Solo3v3TraceRecorder::RecordResult(uint32 instanceId, uint8 winnerTeam)
+{
+    if (!sSolo3v3Config.TraceEnable)
+        return;
+
+    Solo3v3TraceRecord record = { };
+    record.type = SOLO_3V3_TRACE_MATCH_RESULT;
+    record.team = winnerTeam;
+    record.instanceId = instanceId;
+
+    Record(record);
+}
+
+void Solo3v3TraceRecorder::Record(Solo3v3TraceRecord& record)
+{
+    record.time = uint32(GameTime::GetGameTimeMS().count());
+
+    std::lock_guard<std::mutex> guard(lock);
+    pending.push_back(record);
+}
+
+void Solo3v3TraceRecorder::Flush()
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (pending.empty())
+        return;
+
+    std::string configFile = sSolo3v3Config.TraceFile;
+
+    // a new file is started on the first record after the server start or a change of Solo.3v3.Trace.File
+    if (!file.is_open() || fileName != configFile)
+    {
+        if (file.is_open())
+            file.close();
+
+        fileName = configFile;
+        file.open(fileName, std::ios::binary | std::ios::trunc);
+
+        if (!file)
+        {
+            LOG_ERROR("module", "Solo 3v3: could not open the trace file {}, {} events dropped.", fileName, pending.size());
+            pending.clear();
+            return;
+        }
+
+        file.write(reinterpret_cast<char const*>(&SOLO_3V3_TRACE_MAGIC), sizeof(SOLO_3V3_TRACE_MAGIC));
+        file.write(reinterpret_cast<char const*>(&SOLO_3V3_TRACE_VERSION), sizeof(SOLO_3V3_TRACE_VERSION));
+    }
+
+    file.write(reinterpret_cast<char const*>(pending.data()), pending.size() * sizeof(Solo3v3TraceRecord));
+    file.flush();
+    pending.clear();
+}
+
+bool Solo3v3TraceRecorder::Load(std::string const& fileName, std::vector<Solo3v3TraceRecord>& records)
+{
+    std::ifstream input(fileName, std::ios::binary);
+    if (!input)
+        return false;
+
+    uint32 magic = 0;
+    uint32 version = 0;
+    input.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    input.read(reinterpret_cast<char*>(&version), sizeof(version));
+
+    if (!input || magic != SOLO_3V3_TRACE_MAGIC || version != SOLO_3V3_TRACE_VERSION)
+        return false;
+
+    Solo3v3TraceRecord record;
+    while (input.read(reinterpret_cast<char*>(&record), sizeof(record)))
+        records.push_back(record);
+
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_TRACE_H_
+#define _SOLO_3V3_TRACE_H_
+
+#include "Common.h"
+#include "ObjectGuid.h"
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum Solo3v3TraceEventType : uint8
+{
+    SOLO_3V3_TRACE_JOIN         = 0, // bracket, rated, role, class, team and MMR of the player
+    SOLO_3V3_TRACE_LEAVE        = 1, // left the queue before being invited
+    SOLO_3V3_TRACE_INVITE       = 2, // team is the side the player was put on
+    SOLO_3V3_TRACE_ACCEPT       = 3,
+    SOLO_3V3_TRACE_DECLINE      = 4,
+    SOLO_3V3_TRACE_MATCH_FORMED = 5, // mmr is the MMR gap between the two teams
+    SOLO_3V3_TRACE_MATCH_RESULT = 6, // team is the winner
+};
+
+#pragma pack(push, 1)
+struct Solo3v3TraceRecord
+{
+    uint32 time;        // game time in ms
+    uint8 type;
+    uint8 bracket;
+    uint8 isRated;
+    uint8 role;
+    uint8 playerClass;
+    uint8 team;
+    uint16 reserved;
+    uint32 player;      // guid counter
+    uint32 mmr;
+    uint32 instanceId;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(Solo3v3TraceRecord) == 24, "the trace file layout must not change without a version bump");
+
+constexpr uint32 SOLO_3V3_TRACE_MAGIC = 0x52543353; // "S3TR"
+constexpr uint32 SOLO_3V3_TRACE_VERSION = 1;
+
+// Records the solo queue events to a binary trace file (Solo.3v3.Trace.File) while Solo.3v3.Trace.Enable is set,
+// so a busy evening can be replayed offline through the matcher with `.qsolo replay`. Events are buffered and
+// written from the world update, the file starts with the magic and version followed by the raw records.
+class Solo3v3TraceRecorder
+{
+public:
+    static Solo3v3TraceRecorder* instance();
+
+    void RecordJoin(ObjectGuid guid, uint8 bracket, bool isRated, uint8 role, uint8 playerClass, uint8 team, uint32 mmr);
+    void RecordPlayer(Solo3v3TraceEventType type, ObjectGuid guid, uint32 instanceId = 0, uint8 team = 0);
+    void RecordMatch(uint32 instanceId, uint8 bracket, bool isRated, uint32 mmrGap);
+    void RecordResult(uint32 instanceId, uint8 winnerTeam);
+
+    // Writes the buffered records, called from the world update and on shutdown
+    void Flush();
+
+    // Reads a whole trace file, false if the file is missing or not a trace
+    static bool Load(std::string const& fileName, std::vector<Solo3v3TraceRecord>& records);
+
+private:
+    void Record(Solo3v3TraceRecord& record);
+
+    std::vector<Solo3v3TraceRecord> pending;
+    std::ofstream file;
+    std::string fileName;
+    std::mutex lock;
+};
+
+#define sSolo3v3Trace Solo3v3TraceRecorder::instance()
+
+#endif // _SOLO_3V3_TRACE_H_
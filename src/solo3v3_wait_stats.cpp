@@ -0,0 +1,167 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_wait_stats.h"
+#include "solo3v3_config.h"
+#include "GameTime.h"
+#include <cmath>
+#include <fstream>
+
+Solo3v3WaitStats* Solo3v3WaitStats::instance()
+{
+    static Solo3v3WaitStats instance;
+    return &instance;
+}
+
+void Solo3v3WaitStats::AddWait(BattlegroundBracketId bracket_id, bool isRated, Solo3v3TalentCat role, uint32 waitTime)
+{
+    uint32 halfLife = sSolo3v3Config.WaitStatsHalfLife;
+    if (!halfLife || bracket_id >= MAX_BATTLEGROUND_BRACKETS || role >= SOLO_3V3_WAIT_ROLES)
+        return;
+
+    uint32 bucket = 0;
+    while (bucket < SOLO_3V3_WAIT_BUCKET_LIMITS.size() && waitTime >= SOLO_3V3_WAIT_BUCKET_LIMITS[bucket] * IN_MILLISECONDS)
+        ++bucket;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    DecayedHistogram& histogram = histograms[bracket_id][isRated ? 1 : 0][role];
+    Decay(histogram, GameTime::GetGameTimeMS().count(), halfLife);
+
+    histogram.weights[bucket] += 1.0;
+    histogram.waitSum += waitTime;
+    histogram.samples += 1;
+}
+
+uint32 Solo3v3WaitStats::GetEstimate(BattlegroundBracketId bracket_id, bool isRated, Solo3v3TalentCat role)
+{
+    if (!sSolo3v3Config.WaitStatsHalfLife || bracket_id >= MAX_BATTLEGROUND_BRACKETS || role >= SOLO_3V3_WAIT_ROLES)
+        return 0;
+
+    Solo3v3WaitSummary summary = GetSummary(bracket_id, isRated, role);
+    if (summary.weight < MIN_ESTIMATE_WEIGHT)
+        return 0;
+
+    return summary.p50;
+}
+
+Solo3v3WaitSummary Solo3v3WaitStats::GetSummary(BattlegroundBracketId bracket_id, bool isRated, Solo3v3TalentCat role)
+{
+    if (bracket_id >= MAX_BATTLEGROUND_BRACKETS || role >= SOLO_3V3_WAIT_ROLES)
+        return Solo3v3WaitSummary();
+
+    std::lock_guard<std::mutex> guard(lock);
+    return Summarize(histograms[bracket_id][isRated ? 1 : 0][role]);
+}
+
+bool Solo3v3WaitStats::WriteCsv(std::string const& fileName)
+{
+    std::ofstream file(fileName, std::ios::trunc);
+    if (!file)
+        return false;
+
+    static char const* const roleNames[SOLO_3V3_WAIT_ROLES] = { "melee", "ranged", "healer" };
+
+    file << "bracket,rated,role,samples,weight,mean_s,p50_s,p90_s\n";
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (uint32 bracket = 0; bracket < MAX_BATTLEGROUND_BRACKETS; ++bracket)
+        for (uint8 rated = 0; rated < 2; ++rated)
+            for (uint8 role = 0; role < SOLO_3V3_WAIT_ROLES; ++role)
+            {
+                DecayedHistogram& histogram = histograms[bracket][rated][role];
+                if (!histogram.samples)
+                    continue;
+
+                Solo3v3WaitSummary summary = Summarize(histogram);
+                file << bracket << ',' << uint32(rated) << ',' << roleNames[role] << ',' << summary.samples << ',' << summary.weight << ','
+                    << summary.mean / IN_MILLISECONDS << ',' << summary.p50 / IN_MILLISECONDS << ',' << summary.p90 / IN_MILLISECONDS << '\n';
+            }
+
+    return true;
+}
+
+void Solo3v3WaitStats::Decay(DecayedHistogram& histogram, uint64 now, uint32 halfLife)
+{
+    if (now <= histogram.lastDecay)
+        return;
+
+    double factor = std::exp2(-double(now - histogram.lastDecay) / halfLife);
+
+    for (double& weight : histogram.weights)
+        weight *= factor;
+
+    histogram.waitSum *= factor;
+    histogram.lastDecay = now;
+}
+
+double Solo3v3WaitStats::Weight(DecayedHistogram const& histogram)
+{
+    double weight = 0.0;
+    for (double bucketWeight : histogram.weights)
+        weight += bucketWeight;
+
+    return weight;
+}
+
+uint32 Solo3v3WaitStats::Quantile(DecayedHistogram const& histogram, double weight, double fraction)
+{
+    double target = weight * fraction;
+    double seen = 0.0;
+
+    for (uint32 i = 0; i < SOLO_3V3_WAIT_BUCKETS; ++i)
+    {
+        double bucketWeight = histogram.weights[i];
+        if (seen + bucketWeight < target || bucketWeight <= 0.0)
+        {
+            seen += bucketWeight;
+            continue;
+        }
+
+        uint32 lower = i ? SOLO_3V3_WAIT_BUCKET_LIMITS[i - 1] * IN_MILLISECONDS : 0;
+
+        // the open ended bucket has no width to interpolate over
+        if (i == SOLO_3V3_WAIT_BUCKETS - 1)
+            return lower;
+
+        uint32 upper = SOLO_3V3_WAIT_BUCKET_LIMITS[i] * IN_MILLISECONDS;
+        return lower + uint32((upper - lower) * ((target - seen) / bucketWeight));
+    }
+
+    return 0;
+}
+
+Solo3v3WaitSummary Solo3v3WaitStats::Summarize(DecayedHistogram& histogram)
+{
+    Solo3v3WaitSummary summary;
+    summary.samples = histogram.samples;
+
+    uint32 halfLife = sSolo3v3Config.WaitStatsHalfLife;
+    if (halfLife)
+        Decay(histogram, GameTime::GetGameTimeMS().count(), halfLife);
+
+    summary.weight = Weight(histogram);
+    if (summary.weight <= 0.0)
+        return summary;
+
+    summary.mean = uint32(histogram.waitSum / summary.weight);
+    summary.p50 = Quantile(histogram, summary.weight, 0.5);
+    summary.p90 = Quantile(histogram, summary.weight, 0.9);
+
+    return summary;
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_WAIT_STATS_H_
+#define _SOLO_3V3_WAIT_STATS_H_
+
+#include "solo3v3.h"
+#include <array>
+#include <mutex>
+#include <string>
+
+// wait time buckets, upper bounds in seconds, the last bucket is open ended
+constexpr uint32 SOLO_3V3_WAIT_BUCKETS = 9;
+constexpr std::array<uint32, SOLO_3V3_WAIT_BUCKETS - 1> SOLO_3V3_WAIT_BUCKET_LIMITS = { 15, 30, 60, 120, 240, 480, 900, 1800 };
+
+// roles with their own wait stats, MELEE, RANGE and HEALER
+constexpr uint8 SOLO_3V3_WAIT_ROLES = HEALER + 1;
+
+struct Solo3v3WaitSummary
+{
+    uint32 samples = 0;   // invites since the server start
+    double weight = 0.0;  // decayed number of recent invites
+    uint32 mean = 0;      // ms, decayed
+    uint32 p50 = 0, p90 = 0;
+};
+
+// Queue wait of the invited solo players per level bracket, rating and role, as exponentially decayed
+// histograms (Solo.3v3.WaitStats.HalfLife), so healers and melee get their own estimate instead of the core
+// arena average, and the estimate follows the population of the last hours.
+class Solo3v3WaitStats
+{
+public:
+    static Solo3v3WaitStats* instance();
+
+    // Called when the player is invited to a match
+    void AddWait(BattlegroundBracketId bracket_id, bool isRated, Solo3v3TalentCat role, uint32 waitTime);
+
+    // Expected wait in ms for a player joining now, 0 if there are too few recent matches to tell
+    uint32 GetEstimate(BattlegroundBracketId bracket_id, bool isRated, Solo3v3TalentCat role);
+
+    Solo3v3WaitSummary GetSummary(BattlegroundBracketId bracket_id, bool isRated, Solo3v3TalentCat role);
+
+    // Writes every bracket, rating and role with samples as csv, for capacity planning
+    bool WriteCsv(std::string const& fileName);
+
+private:
+    struct DecayedHistogram
+    {
+        std::array<double, SOLO_3V3_WAIT_BUCKETS> weights{};
+        double waitSum = 0.0;  // decayed sum of the waits in ms
+        uint64 lastDecay = 0;  // game time in ms
+        uint32 samples = 0;
+    };
+
+    // minimal decayed weight for an estimate
+    static constexpr double MIN_ESTIMATE_WEIGHT = 3.0;
+
+    static void Decay(DecayedHistogram& histogram, uint64 now, uint32 halfLife);
+    static uint32 Quantile(DecayedHistogram const& histogram, double weight, double fraction);
+    static double Weight(DecayedHistogram const& histogram);
+
+    Solo3v3WaitSummary Summarize(DecayedHistogram& histogram);
+
+    std::array<std::array<std::array<DecayedHistogram, SOLO_3V3_WAIT_ROLES>, 2>, MAX_BATTLEGROUND_BRACKETS> histograms;
+    std::mutex lock;
+};
+
+#define sSolo3v3WaitStats Solo3v3WaitStats::instance()
+
+#endif // _SOLO_3V3_WAIT_STATS_H_
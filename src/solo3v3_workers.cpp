@@ -0,0 +1,179 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "solo3v3_workers.h"
+#include "solo3v3_config.h"
+#include <unordered_set>
+
+Solo3v3MatchWorkers* Solo3v3MatchWorkers::instance()
+{
+    static Solo3v3MatchWorkers instance;
+    return &instance;
+}
+
+Solo3v3MatchWorkers::~Solo3v3MatchWorkers()
+{
+    Stop();
+}
+
+bool Solo3v3MatchWorkers::IsEnabled() const
+{
+    return sSolo3v3Config.MatchmakingWorkerThreads > 0;
+}
+
+bool Solo3v3MatchWorkers::Submit(std::unique_ptr<Solo3v3MatchJob> job)
+{
+    uint8 rated = job->isRated ? 1 : 0;
+
+    if (inFlight[job->bracket_id][rated])
+    {
+        updateRequested[job->bracket_id][rated] = true;
+        return false;
+    }
+
+    inFlight[job->bracket_id][rated] = true;
+    updateRequested[job->bracket_id][rated] = false;
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    // the thread count is only read once, changing it needs a restart
+    if (threads.empty())
+        Start(sSolo3v3Config.MatchmakingWorkerThreads);
+
+    pendingJobs.push_back(std::move(job));
+    condition.notify_one();
+
+    return true;
+}
+
+void Solo3v3MatchWorkers::TakeFinished(std::vector<std::unique_ptr<Solo3v3MatchJob>>& jobs)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (std::unique_ptr<Solo3v3MatchJob>& job : finishedJobs)
+        jobs.push_back(std::move(job));
+
+    finishedJobs.clear();
+}
+
+bool Solo3v3MatchWorkers::Release(Solo3v3MatchJob const& job)
+{
+    uint8 rated = job.isRated ? 1 : 0;
+
+    inFlight[job.bracket_id][rated] = false;
+    return updateRequested[job.bracket_id][rated];
+}
+
+void Solo3v3MatchWorkers::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+
+    condition.notify_all();
+
+    for (std::thread& thread : threads)
+        if (thread.joinable())
+            thread.join();
+
+    threads.clear();
+}
+
+void Solo3v3MatchWorkers::Start(uint32 threadCount)
+{
+    for (uint32 i = 0; i < threadCount; ++i)
+        threads.emplace_back(&Solo3v3MatchWorkers::WorkerThread, this);
+}
+
+void Solo3v3MatchWorkers::WorkerThread()
+{
+    while (true)
+    {
+        std::unique_ptr<Solo3v3MatchJob> job;
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            condition.wait(guard, [this] { return stopping || !pendingJobs.empty(); });
+
+            if (stopping)
+                return;
+
+            job = std::move(pendingJobs.front());
+            pendingJobs.pop_front();
+        }
+
+        Run(*job);
+
+        std::lock_guard<std::mutex> guard(lock);
+        finishedJobs.push_back(std::move(job));
+    }
+}
+
+void Solo3v3MatchWorkers::Run(Solo3v3MatchJob& job)
+{
+    std::vector<Solo3v3Candidate> remaining = job.candidates;
+    Solo3v3MMROrder mmrOrder = job.mmrOrder;
+    bool useMMROrder = job.settings.UsesMMRWindow(job.isRated);
+
+    while (!job.maxArenas || job.matches.size() < job.maxArenas)
+    {
+        Solo3v3MatchSelection selected;
+        if (!sSolo->SelectSolo3v3Match(remaining, job.isRated, job.settings, selected, nullptr, useMMROrder ? &mmrOrder : nullptr))
+            break;
+
+        Solo3v3MatchResult match;
+        std::unordered_set<GroupQueueInfo*> chosen;
+
+        for (uint8 teamId = TEAM_ALLIANCE; teamId < BG_TEAMS_COUNT; ++teamId)
+            for (Solo3v3Candidate const* candidate : selected[teamId])
+            {
+                match[teamId].push_back(*candidate);
+                chosen.insert(candidate->group);
+            }
+
+        job.matches.push_back(std::move(match));
+
+        // the next match is selected from the players that are left, the MMR order is remapped to their new positions
+        std::vector<uint32> newPositions(remaining.size(), UINT32_MAX);
+        uint32 kept = 0;
+
+        for (uint32 i = 0; i < remaining.size(); ++i)
+        {
+            if (chosen.count(remaining[i].group))
+                continue;
+
+            newPositions[i] = kept;
+            remaining[kept++] = remaining[i];
+        }
+
+        remaining.resize(kept);
+
+        if (!useMMROrder)
+            continue;
+
+        for (std::vector<uint32>& positions : mmrOrder)
+        {
+            uint32 count = 0;
+            for (uint32 position : positions)
+                if (newPositions[position] != UINT32_MAX)
+                    positions[count++] = newPositions[position];
+
+            positions.resize(count);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _SOLO_3V3_WORKERS_H_
+#define _SOLO_3V3_WORKERS_H_
+
+#include "solo3v3.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+typedef std::array<std::vector<Solo3v3Candidate>, BG_TEAMS_COUNT> Solo3v3MatchResult;
+
+// Selection of the matches of one bracket, on a snapshot of its queued players
+struct Solo3v3MatchJob
+{
+    BattlegroundQueue* queue;
+    BattlegroundTypeId bgTypeId;
+    PvPDifficultyEntry const* bracketEntry;
+    BattlegroundBracketId bracket_id;
+    uint8 arenaType;
+    bool isRated;
+    uint32 maxArenas; // 0 = as many as possible
+    Solo3v3MatchSettings settings; // taken on the world thread
+
+    std::vector<Solo3v3Candidate> candidates;
+    Solo3v3MMROrder mmrOrder; // only filled for the MMR window selection
+    std::vector<Solo3v3MatchResult> matches; // filled by the worker, disjoint
+};
+
+// Small thread pool running the match selection of the brackets in parallel. Only the selection runs on
+// the workers, the matches are revalidated and created on the world thread (see Solo3v3QueueScheduler).
+// The matchmaking time budget and latency samples cover that world thread part, not the selection.
+class Solo3v3MatchWorkers
+{
+public:
+    static Solo3v3MatchWorkers* instance();
+    ~Solo3v3MatchWorkers();
+
+    // Solo.3v3.Matchmaking.WorkerThreads > 0
+    bool IsEnabled() const;
+
+    // World thread. Returns false if the bracket is still being matched, it is then marked to be updated again once done.
+    bool Submit(std::unique_ptr<Solo3v3MatchJob> job);
+
+    // World thread. Moves out the finished jobs.
+    void TakeFinished(std::vector<std::unique_ptr<Solo3v3MatchJob>>& jobs);
+
+    // World thread. Marks the bracket of a taken job as idle, returns true if an update was requested meanwhile.
+    bool Release(Solo3v3MatchJob const& job);
+
+    void Stop();
+
+private:
+    void Start(uint32 threadCount);
+    void WorkerThread();
+    void Run(Solo3v3MatchJob& job);
+
+    std::vector<std::thread> threads;
+    std::deque<std::unique_ptr<Solo3v3MatchJob>> pendingJobs;
+    std::vector<std::unique_ptr<Solo3v3MatchJob>> finishedJobs;
+    std::mutex lock;
+    std::condition_variable condition;
+    bool stopping = false;
+
+    // only used from the world thread
+    std::array<std::array<bool, 2>, MAX_BATTLEGROUND_BRACKETS> inFlight{};
+    std::array<std::array<bool, 2>, MAX_BATTLEGROUND_BRACKETS> updateRequested{};
+};
+
+#define sSolo3v3Workers Solo3v3MatchWorkers::instance()
+
+#endif // _SOLO_3V3_WORKERS_H_